@@ -37,7 +37,10 @@ void MainWindow::slotImport()
                                                 , tr("Файл базы данных (*.sqlite);;All Files (*)")
                                                 );
      if (!file.isEmpty()) {
-         if(_database.importDB(file)){
+         _worker.closeConnection();             // the worker must release the replaced file
+         bool isImported = _database.importDB(file);
+         _worker.openConnection();
+         if(isImported){
              QMessageBox::information(this, title, tr("База данных успешно импортирована"));
          } else {
             QMessageBox::warning(this, title, tr("Ошибка импорта базы данных"));
@@ -73,12 +76,14 @@ void MainWindow::slotClientAdd()
 void MainWindow::slotClientSeach()
 {
     m_formClientSeach = new ClientSearch;                    //NOTE: Сan we use the local version?
-    auto allClients = _database.clients();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Клиентов", "Список всех Клиентов не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formClientSeach->setInformation(allClients);
+    m_formClientSeach->setInformationSource(_worker.pagedSource<ClientSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+        return db.clientSummaries(page);
+    }), [this](const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Клиентов", "Список всех Клиентов не был получен");
+            qDebug() << errors;
+        }
+    });
     setClientSearchConnect(m_formClientSeach);
     addSubWindowAndShow(m_formClientSeach);
 }
@@ -86,12 +91,14 @@ void MainWindow::slotClientSeach()
 void MainWindow::slotExaminationSeach()
 {
     m_formExaminationSearch = new ExaminationSearch;         //NOTE: Сan we use the local version?
-    auto allExaminations = _database.examinations();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Исследований", "Список всех Исследований не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formExaminationSearch->setInformation(allExaminations);
+    m_formExaminationSearch->setInformationSource(_worker.pagedSource<ExaminationSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+        return db.examinationSummaries(page);
+    }), [this](const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Исследований", "Список всех Исследований не был получен");
+            qDebug() << errors;
+        }
+    });
 
     setExaminationSearchConnect(m_formExaminationSearch);
     addSubWindowAndShow(m_formExaminationSearch);
@@ -107,12 +114,14 @@ void MainWindow::slotProductAdd()
 void MainWindow::slotProductSearch()
 {
     m_formProductSearch = new ProductSeach;
-    auto allProducts = _database.products();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formProductSearch->setInformation(allProducts);
+    m_formProductSearch->setInformationSource(_worker.pagedSource<ProductEntity>([](DatabaseModule& db, DatabaseModule::Page page) {
+        return db.products(page);
+    }), [this](const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
+            qDebug() << errors;
+        }
+    });
     setProductSeachConnect(m_formProductSearch);
     addSubWindowAndShow(m_formProductSearch);
 }
@@ -127,12 +136,14 @@ void MainWindow::slotActivityAdd()
 void MainWindow::slotActivitySearch()
 {
     m_formActivitySeach = new ActivitySeach;
-    auto allActivities = _database.activities();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formActivitySeach->setInformation(allActivities);
+    m_formActivitySeach->setInformationSource(_worker.pagedSource<ActivityEntity>([](DatabaseModule& db, DatabaseModule::Page page) {
+        return db.activities(page);
+    }), [this](const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
+            qDebug() << errors;
+        }
+    });
     setActivitySeachConnect(m_formActivitySeach);
     addSubWindowAndShow(m_formActivitySeach);
 }
@@ -140,12 +151,16 @@ void MainWindow::slotActivitySearch()
 void MainWindow::slotRecipeAdd()
 {
     m_formRecipeEdit = new RecipeEdit;
-    auto allProducts = _database.products();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов для обрласти поиска не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formRecipeEdit->setSearchedProducts(allProducts);
+    RecipeEdit* recipeEdit = m_formRecipeEdit;
+    _worker.run<QVector<ProductEntity>>(recipeEdit, [](DatabaseModule& db) {
+        return db.products();
+    }, [this, recipeEdit](const QVector<ProductEntity>& allProducts, const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов для обрласти поиска не был получен");
+            qDebug() << errors;
+        }
+        recipeEdit->setSearchedProducts(allProducts);
+    });
     setRecipeEditConnect(m_formRecipeEdit);
     addSubWindowAndShow(m_formRecipeEdit);
 }
@@ -153,12 +168,14 @@ void MainWindow::slotRecipeAdd()
 void MainWindow::slotRecipeSearch()
 {
     m_formRecipeSeach = new RecipeSeach;
-    auto allRecipes = _database.recipes();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Рецептов", "Список всех Рецептов не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formRecipeSeach->setInformation(allRecipes);
+    m_formRecipeSeach->setInformationSource(_worker.pagedSource<RecipeSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+        return db.recipeSummaries(page);
+    }), [this](const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Рецептов", "Список всех Рецептов не был получен");
+            qDebug() << errors;
+        }
+    });
     setRecipeSeachConnect(m_formRecipeSeach);
     addSubWindowAndShow(m_formRecipeSeach);
 }
@@ -166,18 +183,26 @@ void MainWindow::slotRecipeSearch()
 void MainWindow::slotActivityCalc()
 {
     m_formActivityCalculation = new ActivityCalculation;
-    auto allProducts = _database.products();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    auto allActivities = _database.activities();
-    if(_database.hasUnwatchedWorkError()){
-        QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
-        qDebug() << _database.unwatchedWorkError();
-    }
-    m_formActivityCalculation->setSearcingActivities(allActivities);
-    m_formActivityCalculation->setSearcingProducts(allProducts);
+    ActivityCalculation* calculation = m_formActivityCalculation;
+    /// Both lists are loaded at the same time on two reader connections
+    _worker.run<QVector<ProductEntity>>(calculation, [](DatabaseModule& db) {
+        return db.products();
+    }, [this, calculation](const QVector<ProductEntity>& allProducts, const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
+            qDebug() << errors;
+        }
+        calculation->setSearcingProducts(allProducts);
+    });
+    _worker.run<QVector<ActivityEntity>>(calculation, [](DatabaseModule& db) {
+        return db.activities();
+    }, [this, calculation](const QVector<ActivityEntity>& allActivities, const QStringList& errors){
+        if(!errors.isEmpty()){
+            QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
+            qDebug() << errors;
+        }
+        calculation->setSearcingActivities(allActivities);
+    });
     setActivityCalculationConnect(m_formActivityCalculation);
     addSubWindowAndShow(m_formActivityCalculation);
 }
@@ -213,7 +238,8 @@ void MainWindow::setClientEditConnect(ClientEdit *ce)
                                        , QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes){
                 m_formClientInfo = new ClientInfo();
                 setClientInfoConnect(m_formClientInfo);
-                m_formClientInfo->setInformation(client, _database.examinations(client));
+                m_formClientInfo->setInformation(client, _database.examinations(client, DatabaseModule::ExaminationListView),
+                                                 _database.examinationTrends(client));
                 _ui.mdiArea->addSubWindow(m_formClientInfo);
                 m_formClientInfo->show();
             }
@@ -235,7 +261,8 @@ void MainWindow::setClientEditConnect(ClientEdit *ce)
                                        , QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes){
                 m_formClientInfo = new ClientInfo();
                 setClientInfoConnect(m_formClientInfo);
-                m_formClientInfo->setInformation(client, _database.examinations(client));
+                m_formClientInfo->setInformation(client, _database.examinations(client, DatabaseModule::ExaminationListView),
+                                                 _database.examinationTrends(client));
                 _ui.mdiArea->addSubWindow(m_formClientInfo);
                 m_formClientInfo->show();
             }
@@ -305,8 +332,15 @@ void MainWindow::setClientInfoConnect(ClientInfo *ci)
     });
 
     connect(ci, &ClientInfo::examinationSelectedForShow, [this, ci](){
+        bool isOk = false;
+        Examination examination = _database.examination(ci->selectedExamination().id(), isOk, ci->client(),
+                                                        DatabaseModule::ExaminationListView);
+        if (!isOk) {
+            QMessageBox::warning(this, tr("Информация о клиенте"), tr("Исследование не найдено"));
+            return;
+        }
         m_formExaminationInfo = new ExaminationInfo;             //NOTE: Сan we use the local version?
-        m_formExaminationInfo->setInformation(ci->selectedExamination());
+        m_formExaminationInfo->setInformation(examination);
         setExaminationInfoConnect(m_formExaminationInfo);
         _ui.mdiArea->addSubWindow(m_formExaminationInfo);
         m_formExaminationInfo->show();
@@ -348,29 +382,42 @@ void MainWindow::setClientSearchConnect(ClientSearch *cs)
     //cs->setAttribute(Qt::WA_DeleteOnClose);
 
     connect(cs, &ClientSearch::seachLineReady, [this, cs](const QString& sl){
-        QVector<Client> clients = _database.clients(sl);
-        if(clients.isEmpty()) {
-            QMessageBox::information(this, tr("Поиск клиентов"), tr("Информация не найдена"));
-        }
-        cs->setInformation(clients);
+        cs->setInformationSource(_worker.pagedSource<ClientSummary>([sl](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.clientSummaries(sl, page);
+        }), [this, cs](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, tr("Поиск клиентов"), tr("Клиенты не были получены из базы данных"));
+                qDebug() << errors;
+            } else if(cs->isEmpty()) {
+                QMessageBox::information(this, tr("Поиск клиентов"), tr("Информация не найдена"));
+            }
+        });
     });
 
     connect(cs, &ClientSearch::selectedForShow, [this, cs](){
-        QVector<Examination> examinations = _database.examinations(cs->selectedClient());
+        bool isOk = false;
+        Client client = _database.client(cs->selectedClient().id, isOk);
+        if (!isOk) {
+            QMessageBox::warning(this, tr("Поиск клиентов"), tr("Клиент не найден"));
+            return;
+        }
+        QVector<Examination> examinations = _database.examinations(client, DatabaseModule::ExaminationListView);
         m_formClientInfo = new ClientInfo;                                //NOTE: Сan we use the local version?
-        m_formClientInfo->setInformation(cs->selectedClient(), examinations);
+        m_formClientInfo->setInformation(client, examinations, _database.examinationTrends(client));
         setClientInfoConnect(m_formClientInfo);
         _ui.mdiArea->addSubWindow(m_formClientInfo);
         m_formClientInfo->show();
     });
 
     connect(cs, &ClientSearch::requireUpdateAllInform, [this, cs](){
-        auto allClients = _database.clients();
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Получение списка Клиентов", "Список всех Клиентов не был получен");
-            qDebug() << _database.unwatchedWorkError();
-        }
-        cs->setInformation(allClients);
+        cs->setInformationSource(_worker.pagedSource<ClientSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.clientSummaries(page);
+        }), [this](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Получение списка Клиентов", "Список всех Клиентов не был получен");
+                qDebug() << errors;
+            }
+        });
     });
 }
 
@@ -422,8 +469,14 @@ void MainWindow::setExaminationInfoConnect(ExaminationInfo *ei)
     ei->setAttribute(Qt::WA_DeleteOnClose);
 
     connect(ei, &ExaminationInfo::editExaminationButtonPressed, [this, ei](){
+        bool isOk = false;
+        Examination examination = _database.examination(ei->examination().id(), isOk, ei->examination().client());
+        if (!isOk) {
+            QMessageBox::warning(this, tr("Редактирование исследования"), tr("Исследование не найдено"));
+            return;
+        }
         m_formExaminationEdit= new ExaminationEdit;
-        m_formExaminationEdit->setInformation(ei->examination());
+        m_formExaminationEdit->setInformation(examination);
         this->setExaminationEditConnect(m_formExaminationEdit);
         this->addSubWindowAndShow(m_formExaminationEdit);
         ei->parent()->deleteLater();
@@ -450,8 +503,17 @@ void MainWindow::setExaminationInfoConnect(ExaminationInfo *ei)
     });
 
     connect(ei, &ExaminationInfo::printExamination, [this, ei](bool ifFull){
+        /// The consultation report needs only its own fields
+        bool isOk = false;
+        Examination examination = _database.examination(ei->examination().id(), isOk, ei->examination().client(),
+                                                        ifFull ? DatabaseModule::ExaminationFullView
+                                                               : DatabaseModule::ExaminationReportView);
+        if (!isOk) {
+            QMessageBox::warning(this, tr("Печать исследования"), tr("Исследование не найдено"));
+            return;
+        }
         Printer* printer = new Printer(this);
-        printer->previewExamination(ei->examination(), ifFull);
+        printer->previewExamination(examination, ifFull);
     });
 }
 
@@ -460,39 +522,56 @@ void MainWindow::setExaminationSearchConnect(ExaminationSearch *es)
     es->setAttribute(Qt::WA_DeleteOnClose);
 
     connect(es, &ExaminationSearch::seachLineDateReady, [this, es](const QDate& from, const QDate& to){
-        QVector<Examination> examinations = _database.examinations(from, to);
-        if(examinations.isEmpty()) {
-            QMessageBox::information(this, tr("Поиск исследований"), tr("Информация не найдена"));
-        }
-        es->setInformation(examinations);
+        es->setInformationSource(_worker.pagedSource<ExaminationSummary>([from, to](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.examinationSummaries(from, to, page);
+        }), [this, es](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, tr("Поиск исследований"), tr("Исследования не были получены из базы данных"));
+                qDebug() << errors;
+            } else if(es->isEmpty()) {
+                QMessageBox::information(this, tr("Поиск исследований"), tr("Информация не найдена"));
+            }
+        });
     });
 
     connect(es, &ExaminationSearch::seachLineClientReady, [this, es](const QString& str){
-        QVector<Examination> examinations;
-        foreach (Client client, _database.clients(str)) {
-            examinations.append(_database.examinations(client));
-        }
-        if(examinations.isEmpty()) {
-            QMessageBox::information(this, tr("Поиск исследований"), tr("Информация не найдена"));
-        }
-        es->setInformation(examinations);
+        es->setInformationSource(_worker.pagedSource<ExaminationSummary>([str](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.examinationSummaries(str, page);
+        }), [this, es](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, tr("Поиск исследований"), tr("Исследования не были получены из базы данных"));
+                qDebug() << errors;
+            } else if(es->isEmpty()) {
+                QMessageBox::information(this, tr("Поиск исследований"), tr("Информация не найдена"));
+            }
+        });
     });
 
     connect(es, &ExaminationSearch::selectedForShow, [this, es](){
+        /// The info window shows only the header, the form fields are loaded to edit or print it
+        bool isOk = false;
+        Examination examination = _database.examination(es->selectedExamination().id, isOk, Client(),
+                                                        DatabaseModule::ExaminationListView);
+        if (!isOk) {
+            QMessageBox::warning(this, tr("Поиск исследований"), tr("Исследование не найдено"));
+            return;
+        }
         m_formExaminationInfo = new ExaminationInfo;                 //NOTE: Сan we use the local version?
-        m_formExaminationInfo->setInformation(es->selectedExamination());
+        m_formExaminationInfo->setInformation(examination);
         setExaminationInfoConnect(m_formExaminationInfo);
         _ui.mdiArea->addSubWindow(m_formExaminationInfo);
         m_formExaminationInfo->show();
     });
 
     connect(es, &ExaminationSearch::requireUpdateAllInform, [this, es](){
-        auto allExaminations = _database.examinations();
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Получение списка Исследований", "Список всех Исследований не был получен");
-            qDebug() << _database.unwatchedWorkError();
-        }
-        es->setInformation(allExaminations);
+        es->setInformationSource(_worker.pagedSource<ExaminationSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.examinationSummaries(page);
+        }), [this](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Получение списка Исследований", "Список всех Исследований не был получен");
+                qDebug() << errors;
+            }
+        });
 
     });
 }
@@ -559,6 +638,12 @@ void MainWindow::setProductInfoConnect(ProductInfo *p)
     });
 
     connect(p, &ProductInfo::deleteProductButtonPressed, [this, p](){
+        int recipes = _database.recipesWithProduct(p->product());
+        if (recipes > 0) {
+            QMessageBox::warning(this, "Удаление Продукта"
+                                 , QString("Продукт используется в рецептах (%1) и не может быть удален").arg(recipes));
+            return;
+        }
         if ( QMessageBox::question(this, "Удаление Продукта"
                                    , "Вы уверены, что хотите удалить Продукт?"
                                    , QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes) {
@@ -583,45 +668,60 @@ void MainWindow::setProductSeachConnect(ProductSeach *p)
 {
     //p->setAttribute(Qt::WA_DeleteOnClose);
 
-    connect(p, &ProductSeach::seachLineProductReady, [this, p](const QString& s){
-        auto products = _database.products(s.split(' '));
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск продуктов", "Продукты с указанным названием не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (products.isEmpty()){
-            QMessageBox::information(this, "Поиск продуктов", "Продукты с указанным названием не были найдены");
-        }
-        p->setInformation(products);
+    /// Ranked by the name index: the best matches come as the only page
+    auto productsByName = [this](const QString& s) {
+        return _worker.pagedSource<ProductEntity>([s](DatabaseModule& db, DatabaseModule::Page page) {
+            return page.afterId == 0 ? db.searchProducts(s, page.limit) : QVector<ProductEntity>();
+        });
+    };
+    connect(p, &ProductSeach::seachLineProductTyped, [p, productsByName](const QString& s){
+        p->setInformationSource(productsByName(s));
+    });
+    connect(p, &ProductSeach::seachLineProductReady, [this, p, productsByName](const QString& s){
+        p->setInformationSource(productsByName(s), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск продуктов", "Продукты с указанным названием не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск продуктов", "Продукты с указанным названием не были найдены");
+            }
+        });
     });
     connect(p, &ProductSeach::seachLineProteinReady, [this, p](const int from, const int to){
-        auto products = _database.products(QPair<float,float>(from, to),'p');
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона белков не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (products.isEmpty()){
-            QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона белков не были найдены");
-        }
-        p->setInformation(products);
+        p->setInformationSource(_worker.pagedSource<ProductEntity>([from, to](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.products(QPair<float,float>(from, to),'p', page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона белков не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона белков не были найдены");
+            }
+        });
     });
     connect(p, &ProductSeach::seachLineFatsReady, [this, p](const int from, const int to){
-        auto products = _database.products(QPair<float,float>(from, to),'f');
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона жиров не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (products.isEmpty()){
-            QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона жиров не были найдены");
-        }
-        p->setInformation(products);
+        p->setInformationSource(_worker.pagedSource<ProductEntity>([from, to](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.products(QPair<float,float>(from, to),'f', page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона жиров не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона жиров не были найдены");
+            }
+        });
     });
     connect(p, &ProductSeach::seachLineCarbohydratesReady, [this, p](const int from, const int to){
-        auto products = _database.products(QPair<float,float>(from, to),'c');
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона углеводов не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (products.isEmpty()){
-            QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона углеводов не были найдены");
-        }
-        p->setInformation(products);
+        p->setInformationSource(_worker.pagedSource<ProductEntity>([from, to](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.products(QPair<float,float>(from, to),'c', page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск продуктов", "Продукты для заданного диапазона углеводов не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск продуктов", "Продукты для заданного диапазона углеводов не были найдены");
+            }
+        });
     });
     connect(p, &ProductSeach::selectedForShow, [this, p](){
         auto selectedProduct = p->selectedProduct();
@@ -632,12 +732,14 @@ void MainWindow::setProductSeachConnect(ProductSeach *p)
     });
 
     connect(p, &ProductSeach::requireUpdateAllInform, [this, p](){
-        auto allProducts = _database.products();
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
-            qDebug() << _database.unwatchedWorkError();
-        }
-        p->setInformation(allProducts);
+        p->setInformationSource(_worker.pagedSource<ProductEntity>([](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.products(page);
+        }), [this](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Получение списка Продуктов", "Список всех Продуктов не был получен");
+                qDebug() << errors;
+            }
+        });
     });
 }
 
@@ -729,24 +831,28 @@ void MainWindow::setActivitySeachConnect(ActivitySeach *p)
     //p->setAttribute(Qt::WA_DeleteOnClose);
 
     connect(p, &ActivitySeach::seachLineActivityReady, [this, p](const QString& s){
-        auto activities = _database.activities(s.split(' '));
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск информации об активности", "Виды двигательной активности по указанному запросу не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (activities.isEmpty()){
-            QMessageBox::information(this, "Поиск информации об активности", "Виды двигательной активности по указанному запросу не были найдены");
-        }
-        p->setInformation(activities);
+        p->setInformationSource(_worker.pagedSource<ActivityEntity>([words = s.split(' ')](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.activities(words, page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск информации об активности", "Виды двигательной активности по указанному запросу не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск информации об активности", "Виды двигательной активности по указанному запросу не были найдены");
+            }
+        });
     });
     connect(p, &ActivitySeach::seachLineKcalReady, [this, p](const int from, const int to){
-        auto products = _database.activities(QPair<float, float>(from, to));
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск информации об активности", "Виды двигательной активности для заданного интервала не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (products.isEmpty()){
-            QMessageBox::information(this, "Поиск информации об активности", "Виды двигательной активности для заданного интервала не были найдены");
-        }
-        p->setInformation(products);
+        p->setInformationSource(_worker.pagedSource<ActivityEntity>([from, to](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.activities(QPair<float, float>(from, to), page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск информации об активности", "Виды двигательной активности для заданного интервала не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск информации об активности", "Виды двигательной активности для заданного интервала не были найдены");
+            }
+        });
     });
     connect(p, &ActivitySeach::selectedForShow, [this, p](){
         auto selectedActivity = p->selectedActivity();
@@ -757,12 +863,14 @@ void MainWindow::setActivitySeachConnect(ActivitySeach *p)
     });
 
     connect(p, &ActivitySeach::requireUpdateAllInform, [this, p](){
-        auto allActivities = _database.activities();
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
-            qDebug() << _database.unwatchedWorkError();
-        }
-        p->setInformation(allActivities);
+        p->setInformationSource(_worker.pagedSource<ActivityEntity>([](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.activities(page);
+        }), [this](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Получение списка Активностей", "Список всех Активностей не был получен");
+                qDebug() << errors;
+            }
+        });
     });
 }
 
@@ -817,7 +925,7 @@ void MainWindow::setRecipeEditConnect(RecipeEdit *p)
     });
 
     connect(p, &RecipeEdit::productSearchLineReady, [this, p](const QString& s){
-        auto products = _database.products(s.split(' '));
+        auto products = _database.searchProducts(s);
         if(_database.hasUnwatchedWorkError()){
             QMessageBox::warning(this, "Поиск продуктов", "Продукты с указанным названием не были получены из базы данных");
             qDebug() << _database.unwatchedWorkError();
@@ -916,48 +1024,44 @@ void MainWindow::setRecipeSeachConnect(RecipeSeach *p)
 {
     //p->setAttribute(Qt::WA_DeleteOnClose);
 
-    connect(p, &RecipeSeach::seachLineRecipeReady, [this, p](const QString& s){
-        auto recipe = _database.recipes(s.split(' '));
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск рецепта", "Рецепты по заданному запросу не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (recipe.isEmpty()){
-            QMessageBox::information(this, "Поиск рецепта", "Рецепты по заданному запросу не были найдены");
-        }
-        p->setInformation(recipe);
+    /// Ranked by the name index: the best matches come as the only page
+    auto recipesByName = [this](const QString& s) {
+        return _worker.pagedSource<RecipeSummary>([s](DatabaseModule& db, DatabaseModule::Page page) {
+            return page.afterId == 0 ? db.searchRecipes(s, page.limit) : QVector<RecipeSummary>();
+        });
+    };
+    connect(p, &RecipeSeach::seachLineRecipeTyped, [p, recipesByName](const QString& s){
+        p->setInformationSource(recipesByName(s));
     });
-    connect(p, &RecipeSeach::seachLineProteinReady, [this, p](const int from, const int to){
-        auto recipe = _database.recipes(QPair<float,float>(from, to),'p');
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск рецепта", "Рецепты для указанного диапазона белков не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (recipe.isEmpty()){
-            QMessageBox::information(this, "Поиск рецепта", "Рецепты для указанного диапазона белков не были найдены");
-        }
-        p->setInformation(recipe);
+    connect(p, &RecipeSeach::seachLineRecipeReady, [this, p, recipesByName](const QString& s){
+        p->setInformationSource(recipesByName(s), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск рецепта", "Рецепты по заданному запросу не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск рецепта", "Рецепты по заданному запросу не были найдены");
+            }
+        });
     });
-    connect(p, &RecipeSeach::seachLineFatsReady, [this, p](const int from, const int to){
-        auto recipe = _database.recipes(QPair<float,float>(from, to),'f');
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск рецепта", "Рецепты для указанного диапазона жиров не были получены из базы данных");
-            qDebug() << _database.unwatchedWorkError();
-        } else if (recipe.isEmpty()){
-            QMessageBox::information(this, "Поиск рецепта", "Рецепты для указанного диапазона жиров не были найдены");
-        }
-        p->setInformation(recipe);
+    connect(p, &RecipeSeach::seachNutrientsReady, [this, p](const RecipeCatalog::Filter& filter){
+        p->setInformationSource(_worker.pagedSource<RecipeSummary>([filter](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.recipeSummaries(filter, page);
+        }), [this, p](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Поиск рецепта", "Рецепты для указанных диапазонов не были получены из базы данных");
+                qDebug() << errors;
+            } else if (p->isEmpty()){
+                QMessageBox::information(this, "Поиск рецепта", "Рецепты для указанных диапазонов не были найдены");
+            }
+        });
     });
-    connect(p, &RecipeSeach::seachLineCarbohydratesReady, [this, p](const int from, const int to){
-        auto recipe = _database.recipes(QPair<float,float>(from, to),'c');
+    connect(p, &RecipeSeach::selectedForShow, [this, p](){
+        auto selectedRecipe = _database.recipe(p->selectedRecipe().id);
         if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Поиск рецепта", "Рецепты для указанного диапазона углеводов не были получены из базы данных");
+            QMessageBox::warning(this, "Поиск рецепта", "Рецепт не был получен из базы данных");
             qDebug() << _database.unwatchedWorkError();
-        } else if (recipe.isEmpty()){
-            QMessageBox::information(this, "Поиск рецепта", "Рецепты для указанного диапазона углеводов не были найдены");
+            return;
         }
-        p->setInformation(recipe);
-    });
-    connect(p, &RecipeSeach::selectedForShow, [this, p](){
-        auto selectedRecipe = p->selectedRecipe();
         m_formRecipeInfo = new RecipeInfo;
         m_formRecipeInfo->setInformation(selectedRecipe);
         this->setRecipeInfoConnect(m_formRecipeInfo);
@@ -965,19 +1069,21 @@ void MainWindow::setRecipeSeachConnect(RecipeSeach *p)
     });
 
     connect(p, &RecipeSeach::requireUpdateAllInform, [this, p](){
-        auto allRecipes = _database.recipes();
-        if(_database.hasUnwatchedWorkError()){
-            QMessageBox::warning(this, "Получение списка Рецептов", "Список всех Рецептов не был получен");
-            qDebug() << _database.unwatchedWorkError();
-        }
-        p->setInformation(allRecipes);
+        p->setInformationSource(_worker.pagedSource<RecipeSummary>([](DatabaseModule& db, DatabaseModule::Page page) {
+            return db.recipeSummaries(page);
+        }), [this](const QStringList& errors){
+            if(!errors.isEmpty()){
+                QMessageBox::warning(this, "Получение списка Рецептов", "Список всех Рецептов не был получен");
+                qDebug() << errors;
+            }
+        });
     });
 }
 
 void MainWindow::setActivityCalculationConnect(ActivityCalculation *p)
 {
     connect(p, &ActivityCalculation::productSearchLineReady, [this, p](const QString& s){
-        auto products = _database.products(s.split(' '));
+        auto products = _database.searchProducts(s);
         if(_database.hasUnwatchedWorkError()){
             QMessageBox::warning(this, "Поиск продуктов", "Продукты с указанным названием не были получены из базы данных");
             qDebug() << _database.unwatchedWorkError();
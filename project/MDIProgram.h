@@ -2,6 +2,7 @@
 #include "ui_MDI_program.h"
 #include "windows.h"
 #include "databasemodule.h"
+#include "databaseworker.h"
 
 
 class MainWindow : public QMainWindow {
@@ -68,5 +69,6 @@ private:
 
     QLabel* m_text;
 
-    DatabaseModule _database;
+    DatabaseModule _database;       // the read-write connection, all the writes go through it
+    DatabaseWorker _worker;         // reader connections for the list loads, off the GUI thread
 };
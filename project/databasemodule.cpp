@@ -1,18 +1,569 @@
 #include "databasemodule.h"
+#include "schemamigrator.h"
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 #include <QFile>
 #include <QDebug>
 #include <QDir>
+#include <QHash>
+#include <QSettings>
 
-DatabaseModule::DatabaseModule()
+#include <algorithm>
+
+namespace {
+
+/// Column lists used by the loaders. Rows are read by column index,
+/// so the order of the names must match the order of the *Column enums.
+const QString PRODUCT_COLUMNS = "id, name, description, proteins, fats, carbohydrates, kkal, units, version";
+enum ProductColumn { ProductId, ProductName, ProductDescription, ProductProteins
+                   , ProductFats, ProductCarbohydrates, ProductKkal, ProductUnits, ProductVersion };
+
+const QString ACTIVITY_COLUMNS = "id, type, kkal_m_km, version";
+enum ActivityColumn { ActivityId, ActivityType, ActivityKkm, ActivityVersion };
+
+const QString CLIENT_COLUMNS = "id, surname, name, patronymic, birth_date, gender, age, tel_number, version";
+enum ClientColumn { ClientId, ClientSurname, ClientName, ClientPatronymic
+                  , ClientBirthDate, ClientGender, ClientAge, ClientTelNumber, ClientVersion };
+
+const QString EXAMINATION_COLUMNS = "id, client_id, is_full_examination, date, version";
+enum ExaminationColumn { ExaminationId, ExaminationClientId, ExaminationIsFull, ExaminationDate, ExaminationVersion
+                       , ExaminationFirstClientColumn };    // the joined Clients columns follow
+
+/// The form fields are stored in ExaminationValues, one row per filled field
+const QString EXAMINATION_VALUE_COLUMNS = "examination_id, field, value_real, value_int, value_text";
+enum ExaminationValueColumn { ValueExaminationId, ValueField, ValueReal, ValueInt, ValueText };
+
+/// Fields printed in the consultation report
+const QString REPORT_FIELDS = "1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 19, 20, 21, 22, 23, 25, 26, "
+                              "37, 38, 39, 40, 41, 44, 45, 46, 47, 51, 69, 71, 75, 78, 79, 85, 86, 87, 88, 90";
+
+/// "a, b" -> "t.a, t.b", for the joined queries
+QString qualifiedColumns(const QString& columns, const QString& table)
+{
+    return table + "." + columns.split(", ").join(", " + table + ".");
+}
+
+ProductEntity productFromColumns(const QSqlQuery& q, int first)
+{
+    ProductEntity product(q.value(first + ProductId).toInt()
+                         , q.value(first + ProductName).toString()
+                         , q.value(first + ProductDescription).toString()
+                         , q.value(first + ProductProteins).toFloat()
+                         , q.value(first + ProductFats).toFloat()
+                         , q.value(first + ProductCarbohydrates).toFloat()
+                         , q.value(first + ProductKkal).toFloat()
+                         , static_cast<ProductEntity::UnitsType>(q.value(first + ProductUnits).toInt()));
+    product.setVersion(q.value(first + ProductVersion).toInt());
+    return product;
+}
+
+ProductEntity productFromRow(const QSqlQuery& q)
+{
+    return productFromColumns(q, 0);
+}
+
+ActivityEntity activityFromRow(const QSqlQuery& q)
+{
+    ActivityEntity activity(q.value(ActivityId).toInt()
+                            , q.value(ActivityType).toString()
+                            , q.value(ActivityKkm).toFloat());
+    activity.setVersion(q.value(ActivityVersion).toInt());
+    return activity;
+}
+
+Client clientFromColumns(const QSqlQuery& q, int first)
+{
+    QString gender = q.value(first + ClientGender).toString();
+    Client client(q.value(first + ClientId).toInt()
+                  , q.value(first + ClientName).toString()
+                  , q.value(first + ClientSurname).toString()
+                  , q.value(first + ClientPatronymic).toString()
+                  , QDate::fromString(q.value(first + ClientBirthDate).toString(), Qt::ISODate)
+                  , gender.isEmpty() ? QChar() : gender.at(0)
+                  , q.value(first + ClientAge).toInt()
+                  , q.value(first + ClientTelNumber).toString());
+    client.setVersion(q.value(first + ClientVersion).toInt());
+    return client;
+}
+
+Client clientFromRow(const QSqlQuery& q)
+{
+    return clientFromColumns(q, 0);
+}
+
+/// Fills everything except the client, which is resolved by the caller, and the form fields
+void examinationFromRow(const QSqlQuery& q, Examination& examination)
+{
+    examination.setId(q.value(ExaminationId).toInt());
+    examination.setIsFullExamination(q.value(ExaminationIsFull).toBool());
+    examination.setDate(QDateTime::fromString(q.value(ExaminationDate).toString(), Qt::ISODate));
+    examination.setVersion(q.value(ExaminationVersion).toInt());
+}
+
+/// Numbers are written back the way they were typed, so the text round-trips
+QString fieldValueFromRow(const QSqlQuery& q)
+{
+    if (!q.isNull(ValueReal)) {
+        return QString::number(q.value(ValueReal).toDouble(), 'g', 15);
+    }
+    if (!q.isNull(ValueInt)) {
+        return QString::number(q.value(ValueInt).toLongLong());
+    }
+    return q.value(ValueText).toString();
+}
+
+/// Binds value_real, value_int and value_text of the field. A number is stored typed
+/// only if it is converted back to the same text, anything else ("70,5", "007") stays TEXT
+void bindFieldValue(QSqlQuery& q, const FormField& field)
+{
+    QVariant real(QVariant::Double), integer(QVariant::LongLong), text(QVariant::String);
+    const QString value = field.value();
+    bool isOk = false;
+
+    if (field.type() == FormField::UShort) {
+        qlonglong number = value.toLongLong(&isOk);
+        isOk = isOk && QString::number(number) == value;
+        if (isOk) {
+            integer = number;
+        }
+    } else if (field.type() == FormField::Float) {
+        double number = value.toDouble(&isOk);
+        isOk = isOk && QString::number(number, 'g', 15) == value;
+        if (isOk) {
+            real = number;
+        }
+    }
+    if (!isOk) {
+        text = value;
+    }
+
+    q.addBindValue(real);
+    q.addBindValue(integer);
+    q.addBindValue(text);
+}
+
+/// Builds every entity of the result set without any additional query
+template<typename Entity, typename RowReader>
+QVector<Entity> materialize(QSqlQuery& q, RowReader readRow)
+{
+    QVector<Entity> entities;
+    while (q.next()) {
+        entities.push_back(readRow(q));
+    }
+    return entities;
+}
+
+/// "a OR b OR ..." over the columns for every search word, with one bind value per column
+QString likeCondition(const QStringList& columns, int wordsCount)
+{
+    QStringList conditions;
+    for (int i = 0; i < wordsCount; ++i) {
+        for (const QString& column : columns) {
+            conditions << column + " LIKE ?";
+        }
+    }
+    return conditions.join(" OR ");
+}
+
+/// '"w1"* OR "w2"*' - FTS5 query matching the rows with a token starting with any of the words
+QString ftsPrefixQuery(const QStringList& words)
+{
+    QStringList terms;
+    for (QString word : words) {
+        terms << "\"" + word.replace("\"", "\"\"") + "\"*";
+    }
+    return terms.join(" OR ");
+}
+
+/// Reindexes a row only when an indexed column is written, not on the totals or the version
+QString ftsUpdateTrigger(const QString& table, const QStringList& columns)
+{
+    const QString list = columns.join(", ");
+    return QString("CREATE TRIGGER IF NOT EXISTS %1_au AFTER UPDATE OF %3 ON %1 BEGIN "
+                   "INSERT INTO %2(%2, rowid, %3) VALUES ('delete', old.id, %4); "
+                   "INSERT INTO %2(rowid, %3) VALUES (new.id, %5); END")
+            .arg(table, table + "Fts", list, "old." + columns.join(", old."), "new." + columns.join(", new."));
+}
+
+/// FTS5 external content table over `table` with the triggers keeping it in sync
+QStringList ftsTableQueries(const QString& table, const QStringList& columns)
+{
+    const QString fts = table + "Fts";
+    const QString list = columns.join(", ");
+    const QString newValues = "new." + columns.join(", new.");
+    const QString oldValues = "old." + columns.join(", old.");
+
+    return {
+        QString("CREATE VIRTUAL TABLE IF NOT EXISTS %1 USING fts5(%2, content='%3', content_rowid='id')")
+                .arg(fts, list, table),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ai AFTER INSERT ON %1 BEGIN "
+                "INSERT INTO %2(rowid, %3) VALUES (new.id, %4); END")
+                .arg(table, fts, list, newValues),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ad AFTER DELETE ON %1 BEGIN "
+                "INSERT INTO %2(%2, rowid, %3) VALUES ('delete', old.id, %4); END")
+                .arg(table, fts, list, oldValues),
+        ftsUpdateTrigger(table, columns),
+        QString("INSERT INTO %1(%1) VALUES ('rebuild')").arg(fts),
+    };
+}
+
+/// Recalculates proteins, fats, carbohydrates and kcal of the matching recipes from their ingredients.
+/// `recipes` is a condition on Recipes.id, e.g. "= new.recipe_id" in a trigger
+QString recipeTotalsUpdate(const QString& recipes)
+{
+    const QString total = "(SELECT COALESCE(SUM(p.%1 * pr.amound * 0.01), 0) FROM ProductsInRecipes pr"
+                          " INNER JOIN Products p ON p.id = pr.product_id WHERE pr.recipe_id = Recipes.id)";
+    return QString("UPDATE Recipes SET proteins = %1, fats = %2, carbohydrates = %3, kcal = %4 WHERE id %5")
+            .arg(total.arg("proteins"), total.arg("fats"), total.arg("carbohydrates"), total.arg("kkal"), recipes);
+}
+
+/// "proteins = proteins + ..., weight = weight + ..." for adding (sign "+") or removing (sign "-")
+/// the ingredient `row` ("new" or "old" in a trigger) from the totals of its recipe
+QString recipeTotalsDelta(const QString& sign, const QString& row)
+{
+    auto nutrient = [&](const QString& column, const QString& productColumn) {
+        return QString("%1 = %1 %2 COALESCE((SELECT p.%3 * %4.amound * 0.01 FROM Products p"
+                       " WHERE p.id = %4.product_id), 0)").arg(column, sign, productColumn, row);
+    };
+    return QStringList{
+        nutrient("proteins", "proteins"),
+        nutrient("fats", "fats"),
+        nutrient("carbohydrates", "carbohydrates"),
+        nutrient("kcal", "kkal"),
+        QString("weight = weight %1 %2.amound").arg(sign, row),
+    }.join(", ");
+}
+
+/// " WHERE (condition) AND id > ? ORDER BY id LIMIT ?" - keyset paging,
+/// the page binds follow the binds of the condition
+QString pagedWhere(const QString& condition, const QString& idColumn)
+{
+    return " WHERE " + (condition.isEmpty() ? QString() : "(" + condition + ") AND ")
+            + idColumn + " > ? ORDER BY " + idColumn + " LIMIT ?";
+}
+
+/// "(?, ?), (?, ?)" for a multi-row INSERT
+QString valuesRows(int columns, int rows)
+{
+    QStringList placeholders;
+    for (int i = 0; i < columns; ++i) {
+        placeholders << "?";
+    }
+    const QString row = "(" + placeholders.join(", ") + ")";
+
+    QStringList values;
+    for (int i = 0; i < rows; ++i) {
+        values << row;
+    }
+    return values.join(", ");
+}
+
+/// Rows of the next chunk of a multi-row INSERT: maxRows, or a power of 2 for the rest,
+/// so an INSERT takes a few shapes and each of them stays in the statement cache
+int chunkRows(int remaining, int maxRows)
+{
+    if (remaining >= maxRows) {
+        return maxRows;
+    }
+    int rows = 1;
+    while (rows * 2 <= remaining) {
+        rows *= 2;
+    }
+    return rows;
+}
+
+/// The last word repeated up to a power of 2 words. The LIKE conditions of the words are
+/// OR-ed, a repeated one matches nothing new, and the statement takes a few shapes only
+QStringList paddedWords(QStringList words)
+{
+    int count = 1;
+    while (count < words.size()) {
+        count *= 2;
+    }
+    while (!words.isEmpty() && words.size() < count) {
+        words << words.last();
+    }
+    return words;
+}
+
+/// A SELECT of a cached statement executed and not read to the end, a caller still reads it
+bool isBeingRead(const QSqlQuery& q)
+{
+    return q.isActive() && q.isSelect() && q.at() != QSql::AfterLastRow;
+}
+
+/// Moves formfield_1..90 of Examinations into the typed ExaminationValues rows.
+/// The conditions mirror bindFieldValue(): a value that does not round-trip stays TEXT.
+QStringList examinationValuesQueries()
+{
+    QStringList querys;
+    querys << "CREATE TABLE `ExaminationValuesStage` ("
+              "`examination_id` INTEGER, `field` INTEGER, `value_real` REAL, `value_int` INTEGER, `value_text` TEXT)";
+
+    foreach (const FormField& field, Examination::schema()) {
+        const QString v = field.name();
+        const QString isInteger = QString("(CAST(CAST(%1 AS INTEGER) AS TEXT) = %1 AND length(%1) <= 15)").arg(v);
+        const QString isReal = QString("(%1 OR (CAST(CAST(%2 AS REAL) AS TEXT) = %2"
+                                       " AND %2 NOT LIKE '%.0' AND %2 NOT LIKE '%e%'))").arg(isInteger, v);
+
+        QString real = "NULL", integer = "NULL", text = v;
+        if (field.type() == FormField::UShort) {
+            integer = QString("CASE WHEN %1 THEN CAST(%2 AS INTEGER) END").arg(isInteger, v);
+            text = QString("CASE WHEN %1 THEN NULL ELSE %2 END").arg(isInteger, v);
+        } else if (field.type() == FormField::Float) {
+            real = QString("CASE WHEN %1 THEN CAST(%2 AS REAL) END").arg(isReal, v);
+            text = QString("CASE WHEN %1 THEN NULL ELSE %2 END").arg(isReal, v);
+        }
+        querys << QString("INSERT INTO ExaminationValuesStage SELECT id, %1, %2, %3, %4 FROM Examinations"
+                          " WHERE %5 IS NOT NULL AND %5 <> ''")
+                  .arg(Examination::fieldNumber(v)).arg(real, integer, text, v);
+    }
+
+    /// Examinations is rebuilt without the form columns. Nothing references it yet,
+    /// so it can be dropped before ExaminationValues gets its foreign key
+    querys << "CREATE TABLE `ExaminationsNarrow` ("
+              "`id`	INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE,"
+              "`client_id`	INTEGER NOT NULL,"
+              "`is_full_examination`	INTEGER NOT NULL,"
+              "`date`	TEXT NOT NULL,"
+              "FOREIGN KEY(`client_id`) REFERENCES `Clients`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
+              ");"
+           << "INSERT INTO ExaminationsNarrow (id, client_id, is_full_examination, date)"
+              " SELECT id, client_id, is_full_examination, date FROM Examinations"
+           << "DROP TABLE Examinations"
+           << "ALTER TABLE ExaminationsNarrow RENAME TO Examinations"
+           << "CREATE INDEX IF NOT EXISTS idx_Examinations_client_id ON Examinations(client_id)"
+           << "CREATE INDEX IF NOT EXISTS idx_Examinations_date ON Examinations(date)"
+           << "CREATE TABLE `ExaminationValues` ("
+              "`examination_id`	INTEGER NOT NULL,"
+              "`field`	INTEGER NOT NULL,"          // N of formfield_N
+              "`value_real`	REAL,"
+              "`value_int`	INTEGER,"
+              "`value_text`	TEXT,"
+              "PRIMARY KEY(`examination_id`, `field`),"
+              "FOREIGN KEY(`examination_id`) REFERENCES `Examinations`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
+              ") WITHOUT ROWID;"
+           << "INSERT INTO ExaminationValues SELECT * FROM ExaminationValuesStage"
+           << "DROP TABLE ExaminationValuesStage";
+    return querys;
+}
+
+/// Ordered schema steps, a new step is appended with the next version.
+/// Version 1 is the original schema, so existing databases (user_version 0) pass it unchanged.
+QVector<SchemaMigrator::Migration> schemaMigrations()
+{
+    QVector<SchemaMigrator::Migration> migrations;
+
+    QString formfieldNames;
+    foreach (FormField field, Examination::schema()) {
+        formfieldNames += QString(" `%1` TEXT, ").arg(field.name());
+    }
+    migrations << SchemaMigrator::Migration{ 1, "Base tables", {
+        QString("CREATE TABLE IF NOT EXISTS `Clients` ("
+                "`id`           INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE,"
+                "`surname`      TEXT NOT NULL,"
+                "`name`         TEXT NOT NULL,"
+                "`patronymic`	TEXT NOT NULL,"
+                "`birth_date`	TEXT NOT NULL,"
+                "`gender`       TEXT NOT NULL,"
+                "`age`          INTEGER NOT NULL,"
+                "`tel_number`	TEXT NOT NULL"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `Examinations` ("
+                "`id`	INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE,"
+                "`client_id`	INTEGER NOT NULL,"
+                "`is_full_examination`	INTEGER NOT NULL,"
+                "`date`	TEXT NOT NULL,"
+                + formfieldNames +
+                "FOREIGN KEY(`client_id`) REFERENCES `Clients`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `Activities` ("
+                "`id`        INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
+                "`type`      TEXT NOT NULL UNIQUE,"
+                "`kkal_m_km`	REAL NOT NULL"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `CookingPoints` ("
+                "`recipe_id`     INTEGER NOT NULL,"
+                "`point_num`     INTEGER NOT NULL,"
+                "`description`	TEXT NOT NULL,"
+                "    FOREIGN KEY(`recipe_id`) REFERENCES `Recipes`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `Products` ("
+                "`id`	INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
+                "`name`	TEXT NOT NULL UNIQUE,"
+                "`proteins`	REAL NOT NULL,"
+                "`fats`	REAL NOT NULL,"
+                "`carbohydrates`	REAL NOT NULL,"
+                "`kkal`	REAL NOT NULL,"
+                "`description`	TEXT NOT NULL,"
+                "`units`	INTEGER NOT NULL"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `ProductsInRecipes` ("
+                "`recipe_id`	INTEGER NOT NULL,"
+                "`product_id`	INTEGER NOT NULL,"
+                "`amound`	REAL NOT NULL,"
+                "FOREIGN KEY(`product_id`) REFERENCES `Products`(`id`) ON UPDATE CASCADE,"
+                "FOREIGN KEY(`recipe_id`) REFERENCES `Recipes`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
+                ");"),
+        QString("CREATE TABLE IF NOT EXISTS `Recipes`("
+                "`id`	INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
+                "`name`	TEXT NOT NULL,"
+                "`proteins`	REAL NOT NULL,"
+                "`fats`	REAL NOT NULL,"
+                "`carbohydrates`	REAL NOT NULL,"
+                "`kcal`	REAL NOT NULL"
+                ");"),
+    } };
+
+    migrations << SchemaMigrator::Migration{ 2, "Secondary indexes", {
+        "CREATE INDEX IF NOT EXISTS idx_Examinations_client_id ON Examinations(client_id)",
+        "CREATE INDEX IF NOT EXISTS idx_Examinations_date ON Examinations(date)",
+        "CREATE INDEX IF NOT EXISTS idx_ProductsInRecipes_recipe_id ON ProductsInRecipes(recipe_id)",
+        "CREATE INDEX IF NOT EXISTS idx_ProductsInRecipes_product_id ON ProductsInRecipes(product_id)",  // foreign key checks on product delete
+        "CREATE INDEX IF NOT EXISTS idx_CookingPoints_recipe_id ON CookingPoints(recipe_id, point_num)",
+        "CREATE INDEX IF NOT EXISTS idx_Products_proteins ON Products(proteins)",
+        "CREATE INDEX IF NOT EXISTS idx_Products_fats ON Products(fats)",
+        "CREATE INDEX IF NOT EXISTS idx_Products_carbohydrates ON Products(carbohydrates)",
+        "CREATE INDEX IF NOT EXISTS idx_Products_kkal ON Products(kkal)",
+    } };
+
+    migrations << SchemaMigrator::Migration{ 3, "Full text search tables",
+        ftsTableQueries("Products", {"name", "description"})
+        + ftsTableQueries("Recipes", {"name"})
+        + ftsTableQueries("Clients", {"surname", "name", "patronymic"}),
+        true };
+
+    migrations << SchemaMigrator::Migration{ 4, "Typed examination values", examinationValuesQueries() };
+
+    /// Incremented by every change, an edit saves only over the version it was read from
+    migrations << SchemaMigrator::Migration{ 5, "Row versions", {
+        "ALTER TABLE Products ADD COLUMN version INTEGER NOT NULL DEFAULT 0",
+        "ALTER TABLE Recipes ADD COLUMN version INTEGER NOT NULL DEFAULT 0",
+        "ALTER TABLE Activities ADD COLUMN version INTEGER NOT NULL DEFAULT 0",
+        "ALTER TABLE Clients ADD COLUMN version INTEGER NOT NULL DEFAULT 0",
+        "ALTER TABLE Examinations ADD COLUMN version INTEGER NOT NULL DEFAULT 0",
+    } };
+
+    /// The totals follow the ingredients and the products. The first step repairs
+    /// the totals that older versions left from the first save of a recipe
+    migrations << SchemaMigrator::Migration{ 6, "Recipe totals", {
+        recipeTotalsUpdate("IS NOT NULL"),
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_totals_ai AFTER INSERT ON ProductsInRecipes BEGIN "
+            + recipeTotalsUpdate("= new.recipe_id") + "; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_totals_ad AFTER DELETE ON ProductsInRecipes BEGIN "
+            + recipeTotalsUpdate("= old.recipe_id") + "; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_totals_au AFTER UPDATE ON ProductsInRecipes BEGIN "
+            + recipeTotalsUpdate("IN (old.recipe_id, new.recipe_id)") + "; END",
+        "CREATE TRIGGER IF NOT EXISTS Products_totals_au AFTER UPDATE OF proteins, fats, carbohydrates, kkal ON Products BEGIN "
+            + recipeTotalsUpdate("IN (SELECT recipe_id FROM ProductsInRecipes WHERE product_id = new.id)") + "; END",
+        "CREATE INDEX IF NOT EXISTS idx_Recipes_proteins ON Recipes(proteins)",
+        "CREATE INDEX IF NOT EXISTS idx_Recipes_fats ON Recipes(fats)",
+        "CREATE INDEX IF NOT EXISTS idx_Recipes_carbohydrates ON Recipes(carbohydrates)",
+        "CREATE INDEX IF NOT EXISTS idx_Recipes_kcal ON Recipes(kcal)",
+    } };
+
+    /// The weight of the ingredients, for the nutrients per 100 g
+    const QString weightUpdate = "UPDATE Recipes SET weight = (SELECT COALESCE(SUM(amound), 0)"
+                                 " FROM ProductsInRecipes WHERE recipe_id = Recipes.id) WHERE id ";
+    migrations << SchemaMigrator::Migration{ 7, "Recipe weights", {
+        "ALTER TABLE Recipes ADD COLUMN weight REAL NOT NULL DEFAULT 0",
+        weightUpdate + "IS NOT NULL",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_weight_ai AFTER INSERT ON ProductsInRecipes BEGIN "
+            + weightUpdate + "= new.recipe_id; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_weight_ad AFTER DELETE ON ProductsInRecipes BEGIN "
+            + weightUpdate + "= old.recipe_id; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_weight_au AFTER UPDATE OF recipe_id, amound ON ProductsInRecipes BEGIN "
+            + weightUpdate + "IN (old.recipe_id, new.recipe_id); END",
+    } };
+
+    /// One trigger per change of an ingredient, it adds or subtracts that ingredient only
+    /// instead of summing all the ingredients of the recipe twice
+    migrations << SchemaMigrator::Migration{ 8, "Incremental recipe totals", {
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_totals_ai",
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_totals_ad",
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_totals_au",
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_weight_ai",
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_weight_ad",
+        "DROP TRIGGER IF EXISTS ProductsInRecipes_weight_au",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_nutrition_ai AFTER INSERT ON ProductsInRecipes BEGIN "
+            "UPDATE Recipes SET " + recipeTotalsDelta("+", "new") + " WHERE id = new.recipe_id; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_nutrition_ad AFTER DELETE ON ProductsInRecipes BEGIN "
+            "UPDATE Recipes SET " + recipeTotalsDelta("-", "old") + " WHERE id = old.recipe_id; END",
+        "CREATE TRIGGER IF NOT EXISTS ProductsInRecipes_nutrition_au"
+            " AFTER UPDATE OF recipe_id, product_id, amound ON ProductsInRecipes BEGIN "
+            "UPDATE Recipes SET " + recipeTotalsDelta("-", "old") + " WHERE id = old.recipe_id; "
+            "UPDATE Recipes SET " + recipeTotalsDelta("+", "new") + " WHERE id = new.recipe_id; END",
+    } };
+
+    /// The first statement fails where step 3 was skipped, then there is nothing to replace
+    migrations << SchemaMigrator::Migration{ 9, "Full text search on the indexed columns only", {
+        "SELECT count(*) FROM ProductsFts",
+        "DROP TRIGGER IF EXISTS Products_au",
+        "DROP TRIGGER IF EXISTS Recipes_au",
+        "DROP TRIGGER IF EXISTS Clients_au",
+        ftsUpdateTrigger("Products", {"name", "description"}),
+        ftsUpdateTrigger("Recipes", {"name"}),
+        ftsUpdateTrigger("Clients", {"surname", "name", "patronymic"}),
+        },
+        true };
+
+    /// Recipes added with the triggers of step 8 were saved with their ingredients counted twice
+    migrations << SchemaMigrator::Migration{ 10, "Recalculate recipe totals", {
+        recipeTotalsUpdate("IS NOT NULL"),
+        weightUpdate + "IS NOT NULL",
+    } };
+
+    return migrations;
+}
+
+/// One catalog for all the connections, they share the database file
+ProductCatalog& sharedProductCatalog()
+{
+    static ProductCatalog catalog;
+    return catalog;
+}
+
+RecipeCatalog& sharedRecipeCatalog()
+{
+    static RecipeCatalog catalog;
+    return catalog;
+}
+
+EntityCache& sharedEntityCache()
+{
+    static EntityCache cache;
+    return cache;
+}
+
+ExaminationTrendsCache& sharedExaminationTrends()
+{
+    static ExaminationTrendsCache cache;
+    return cache;
+}
+
+} // namespace
+
+DatabaseModule::DatabaseModule(const QString &connectionName, ConnectionMode mode)
 {
     if (!QSqlDatabase::drivers().contains("QSQLITE")){
         qDebug() << "Error: " << Q_FUNC_INFO
                  << "Unable to load database. This program needs the SQLITE driver";
         return;
     }
-    _db = QSqlDatabase::addDatabase(_DB_TYPE);
+    _db = QSqlDatabase::addDatabase(_DB_TYPE, connectionName);
+
+    /// A reader neither creates nor migrates the file, the read-write connection does it
+    if (mode == ReadOnly) {
+        _db.setConnectOptions("QSQLITE_OPEN_READONLY");
+        _db.setDatabaseName(_DB_NAME);
+        if (!_db.open()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << _db.lastError().text();
+            return;
+        }
+        applyConnectionProfile();
+        detectFullTextSearch();
+        return;
+    }
 
     if (!QFile::exists(_DB_NAME)){
         initEmptyDB();
@@ -20,19 +571,58 @@ DatabaseModule::DatabaseModule()
         _db.setDatabaseName(_DB_NAME);
     }
 
-    if (!_db.open()) {
+    if (!_db.isOpen() && !_db.open()) {
         qDebug() << "Error: " << Q_FUNC_INFO
                  << _db.lastError().text();
         QFile::remove(_DB_NAME);
         initEmptyDB();
     }
+
+    applyConnectionProfile();
+    upgradeSchema();
+}
+
+DatabaseModule::~DatabaseModule()
+{
+    clearStatementCache();
+
+    /// A named connection belongs to this module only, e.g. the one of the worker thread
+    const QString connectionName = _db.connectionName();
+    if (connectionName != QLatin1String(QSqlDatabase::defaultConnection)) {
+        _db.close();
+        _db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+}
+
+template<typename BindRow>
+bool DatabaseModule::insertRows(const QString &insert, int columns, int count, BindRow bindRow, QVector<unsigned> *ids)
+{
+    for (int first = 0, rows = 0; first < count; first += rows) {
+        rows = chunkRows(count - first, ROWS_PER_INSERT);
+        QSqlQuery q = cachedQuery(insert + " VALUES " + valuesRows(columns, rows));
+        for (int i = first; i < first + rows; ++i) {
+            bindRow(q, i);
+        }
+        if (!q.exec()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+            return false;
+        }
+        if (ids) {
+            /// The rows of one INSERT get consecutive ids, the id of the last one is reported
+            const unsigned lastId = q.lastInsertId().toUInt();
+            for (int i = rows - 1; i >= 0; --i) {
+                *ids << lastId - unsigned(i);
+            }
+        }
+    }
+    return true;
 }
 
 unsigned DatabaseModule::addProduct(const ProductEntity &pe)
 {
-    QSqlQuery q;
-    q.prepare("INSERT INTO Products (name, description, proteins, fats, carbohydrates, kkal, units)"
-              "VALUES( ?, ?, ?, ?, ?, ?, ?);");
+    QSqlQuery q = cachedQuery("INSERT INTO Products (name, description, proteins, fats, carbohydrates, kkal, units)"
+                              "VALUES( ?, ?, ?, ?, ?, ?, ?);");
     q.addBindValue(pe.name());
     q.addBindValue(pe.description());
     q.addBindValue(pe.proteins());
@@ -44,142 +634,155 @@ unsigned DatabaseModule::addProduct(const ProductEntity &pe)
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
         return 0;
     }
+    sharedProductCatalog().invalidate();
     ///
     return q.lastInsertId().toUInt();
 }
 
+QVector<unsigned> DatabaseModule::addProducts(const QVector<ProductEntity> &products)
+{
+    QVector<unsigned> ids;
+    if (!beginTransaction()) {
+        return ids;
+    }
+    bool isOk = insertRows("INSERT INTO Products (name, description, proteins, fats, carbohydrates, kkal, units)", 7,
+                           products.size(), [&products](QSqlQuery& q, int i) {
+        q.addBindValue(products[i].name());
+        q.addBindValue(products[i].description());
+        q.addBindValue(products[i].proteins());
+        q.addBindValue(products[i].fats());
+        q.addBindValue(products[i].carbohydrates());
+        q.addBindValue(products[i].kilocalories());
+        q.addBindValue(static_cast<int>(products[i].units()));
+    }, &ids);
+    bool isCommitted = endTransaction(isOk);
+    sharedProductCatalog().invalidate();     // could be reloaded before the commit
+    return isCommitted ? ids : QVector<unsigned>();
+}
+
 void DatabaseModule::deleteProduct(const ProductEntity &product)
 {
-    QSqlQuery q;
-    q.prepare("DELETE FROM Products WHERE id=?");
+    /// ProductsInRecipes references the product without ON DELETE, the recipes must not lose ingredients
+    const int recipes = recipesWithProduct(product);
+    if (recipes != 0) {
+        m_errorList << "Error: in " << Q_FUNC_INFO
+                    << QString("The product is an ingredient of %1 recipes").arg(recipes);
+        return;
+    }
+
+    QSqlQuery q = cachedQuery("DELETE FROM Products WHERE id=?");
     q.addBindValue(product.id());
     if(!q.exec()) {
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+        return;
+    }
+    sharedProductCatalog().invalidate();
+    sharedEntityCache().remove(EntityCache::ProductKind, product.id());
+    sharedEntityCache().removeAll(EntityCache::RecipeKind);     // the recipes hold copies of their products
+}
+
+int DatabaseModule::recipesWithProduct(const ProductEntity &product) const
+{
+    QSqlQuery q = cachedQuery("SELECT COUNT(DISTINCT recipe_id) FROM ProductsInRecipes WHERE product_id=?");
+    q.addBindValue(product.id());
+    if(!q.exec() || !q.next()) {
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        return -1;
     }
+    const int count = q.value(0).toInt();
+    q.finish();                         // read, the cached statement can be handed out again
+    return count;
 }
 
 ProductEntity DatabaseModule::product(unsigned id)
 {
-    QSqlQuery q;
-    q.prepare("SELECT * FROM Products WHERE id=?");
+    ProductEntity cached;
+    if (sharedEntityCache().find(int(id), cached)) {
+        return cached;
+    }
+    const quint64 generation = sharedEntityCache().generation();
+
+    QSqlQuery q = cachedQuery("SELECT " + PRODUCT_COLUMNS + " FROM Products WHERE id=?");
     q.addBindValue(id);
     if(!q.exec()){
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
-        ProductEntity();
+        return ProductEntity();
     }
     ///
-    q.next();
-    ///
-    if(!q.isValid()){
+    if(!q.next()){
         qDebug() << "Error:" << Q_FUNC_INFO
                  << "In DB has no Product with id:" + QString::number(id);
+        return ProductEntity(id, QString(), QString(), 0, 0, 0, 0, ProductEntity::UNDEF);
     }
     ///
-    QString name =        q.value("name").toString();
-    QString description = q.value("description").toString();
-    float proteints =     q.value("proteins").toFloat();
-    float fats =          q.value("fats").toFloat();
-    float carbohydrates = q.value("carbohydrates").toFloat();
-    float kkal =          q.value("kkal").toFloat();
-    int units =           q.value("units").toInt();
-    return ProductEntity(id, name, description
-                         , proteints, fats, carbohydrates, kkal
-                         , static_cast<ProductEntity::UnitsType>(units));
+    cached = productFromRow(q);
+    q.finish();
+    sharedEntityCache().insert(cached, generation);
+    return cached;
 }
 
-QVector<ProductEntity> DatabaseModule::products()
+QVector<ProductEntity> DatabaseModule::products(Page page)
 {
-    QVector<ProductEntity> products;
-    ///
-    QSqlQuery q("SELECT id FROM Products");
-    if(!q.exec()) {
-        m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
-        return products;
-    }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        ProductEntity c = this->product(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            products.push_back(c);
-        }
-    }
-    return products;
+    return loadProducts(QString(), QVariantList(), page);
 }
 
-QVector<ProductEntity> DatabaseModule::products(const QStringList &seachLine)
+QVector<ProductEntity> DatabaseModule::products(const QStringList &seachLine, Page page)
 {
-    QVector<ProductEntity> products;
-    foreach (QString snp, seachLine) {
-        QSqlQuery q(QString(" SELECT id FROM Products     "
-                            " WHERE name LIKE '%%1%'       "
-                            "    OR description LIKE '%%2%'"
-                            ).arg(snp).arg(snp));
-        if(!q.exec()){
-            m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-            return products;
-        }
+    QStringList words = seachLine.filter(QRegExp("\\S"));
+    if (words.isEmpty()) {
+        return products(page);
+    }
 
-        while(q.next()) {
-            auto prevErrorSize =  m_errorList.size();
-            ProductEntity c = this->product(q.value("id").toInt());
-            auto avterErrorSize = m_errorList.size();
-            if(prevErrorSize == avterErrorSize) {
-                products.push_back(c);
-            }
-        }
+    QVariantList binds;
+    if (m_isFullTextSearch) {
+        binds << ftsPrefixQuery(words);
+        return loadProducts("id IN (SELECT rowid FROM ProductsFts WHERE ProductsFts MATCH ?)", binds, page);
+    }
+    words = paddedWords(words);
+    foreach (const QString& word, words) {
+        binds << "%" + word + "%" << "%" + word + "%";
     }
-    return products;
+    return loadProducts(likeCondition({"name", "description"}, words.size()), binds, page);
 }
 
-QVector<ProductEntity> DatabaseModule::products(QPair<float, float> interval, const char type)
+QVector<ProductEntity> DatabaseModule::products(QPair<float, float> interval, const char type, Page page)
 {
-    QVector<ProductEntity> products;
-    ///
-    QString stype, prefix = " WHERE %1 BETWEEN %2 AND %3";
+    ProductCatalog::Filter filter;
+    ProductCatalog::Range range{ interval.first, interval.second };
     switch (type) {
-    case 'c': { stype = "carbohydrates"; } break;
-    case 'f': { stype = "fats"; } break;
-    case 'p': { stype = "proteins"; } break;
-    case 'k': { stype = "kkal"; } break;
+    case 'c': { filter.carbohydrates = range; } break;
+    case 'f': { filter.fats = range; } break;
+    case 'p': { filter.proteins = range; } break;
+    case 'k': { filter.kilocalories = range; } break;
     default: {
-        stype = "";
-        prefix = "";
-    }
-    }
-    QSqlQuery q("SELECT id FROM Products"
-                    "" + prefix.arg(stype).arg(interval.first).arg(interval.second));
-    if(!q.exec()){
-        m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-        return products;
+        return products(page);
     }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        ProductEntity c = this->product(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            products.push_back(c);
-        }
     }
-    return products;
+    return products(filter, page);
 }
 
-void DatabaseModule::changeProductInformation(const ProductEntity &newProduct)
+QVector<ProductEntity> DatabaseModule::products(const ProductCatalog::Filter &filter, Page page)
 {
-    //call this for testing to exists product
-    auto prevErrorSize =  m_errorList.size();
-    product(newProduct.id());
-    auto avterErrorSize = m_errorList.size();
-    if(prevErrorSize != avterErrorSize) {
-        m_errorList << "Error:" << Q_FUNC_INFO << " Error with searching product for update";
-        return;
+    ProductCatalog snapshot;
+    return loadedProductCatalog(snapshot).products(filter, page.afterId, page.limit);
+}
+
+QVector<ProductEntity> DatabaseModule::searchProducts(const QString &text, int limit)
+{
+    if (SearchIndex::words(text).isEmpty()) {
+        return products(Page{0, limit});
     }
+    ProductCatalog snapshot;
+    return loadedProductCatalog(snapshot).search(text, limit);
+}
 
-    QSqlQuery q;
-    q.prepare("UPDATE Products "
-              "SET name = ?, description = ?, proteins = ?, fats = ?, carbohydrates = ?, kkal = ?, units = ? "
-              "WHERE id = ?"
-              );
+void DatabaseModule::changeProductInformation(ProductEntity &newProduct)
+{
+    QSqlQuery q = cachedQuery("UPDATE Products "
+                              "SET name = ?, description = ?, proteins = ?, fats = ?, carbohydrates = ?, kkal = ?, units = ?, "
+                              "version = version + 1 "
+                              "WHERE id = ? AND version = ?"
+                              );
     q.addBindValue(newProduct.name());
     q.addBindValue(newProduct.description());
     q.addBindValue(newProduct.proteins());
@@ -188,229 +791,226 @@ void DatabaseModule::changeProductInformation(const ProductEntity &newProduct)
     q.addBindValue(newProduct.kilocalories());
     q.addBindValue(newProduct.units());
     q.addBindValue(newProduct.id());
+    q.addBindValue(newProduct.version());
 
     if(!q.exec()) {
         m_errorList << "Error:" << Q_FUNC_INFO <<  q.lastError().text();
         return;
     }
+    if (q.numRowsAffected() == 0) {
+        m_errorList << "Error:" << Q_FUNC_INFO << notUpdatedReason("Products", newProduct.id(), newProduct.version());
+        return;
+    }
+    newProduct.setVersion(newProduct.version() + 1);
+    sharedProductCatalog().invalidate();
+    sharedRecipeCatalog().invalidate();         // the totals of its recipes were recalculated
+    sharedEntityCache().remove(EntityCache::ProductKind, newProduct.id());
+    sharedEntityCache().removeAll(EntityCache::RecipeKind);
 }
 
 unsigned DatabaseModule::addRecipe(const RecipeEntity &re)
 {
-    ///
-    QSqlQuery q;
-    q.prepare("INSERT INTO Recipes (name, proteins, fats, carbohydrates, kcal )"
-              "VALUES( ?, ?, ?, ?, ? );");
-    q.addBindValue(re.name());
-    q.addBindValue(re.proteins());
-    q.addBindValue(re.fats());
-    q.addBindValue(re.carbohydrates());
-    q.addBindValue(re.kkal());
-    if(!q.exec()) {
-        qDebug() <<
-        m_errorList << "Error: in " << Q_FUNC_INFO << "!q!" << q.lastError().text();
-        return 0;
+    const QVector<unsigned> ids = addRecipes({ re });
+    return ids.isEmpty() ? 0 : ids.first();
+}
+
+QVector<unsigned> DatabaseModule::addRecipes(const QVector<RecipeEntity> &recipes)
+{
+    QVector<unsigned> ids;
+    if (!beginTransaction()) {
+        return ids;
+    }
+    /// The totals start at 0, the triggers of ProductsInRecipes add every ingredient
+    bool isOk = insertRows("INSERT INTO Recipes (name, proteins, fats, carbohydrates, kcal)", 5,
+                           recipes.size(), [&recipes](QSqlQuery& q, int i) {
+        q.addBindValue(recipes[i].name());
+        for (int total = 0; total < 4; ++total) {
+            q.addBindValue(0);
+        }
+    }, &ids);
+
+    /// The cooking points and the ingredients of all the recipes: the index of the recipe and of the row
+    QVector<QPair<int, int>> points;
+    QVector<QPair<int, int>> ingredients;
+    for (int r = 0; isOk && r < recipes.size(); ++r) {
+        for (int i = 0; i < recipes[r].cookingPoints().size(); ++i) {
+            points << qMakePair(r, i);
+        }
+        for (int i = 0; i < recipes[r].products().size(); ++i) {
+            ingredients << qMakePair(r, i);
+        }
     }
-    ///
-    auto recipeID = q.lastInsertId().toUInt();
-    ///
-    insertIntoCookingPoints(recipeID, re.cookingPoints());
-    insertIntoProductsInRecipes(recipeID, re.products());
-    ///
-    return recipeID;
+    isOk = isOk && insertRows("INSERT INTO CookingPoints (recipe_id, point_num, description)", 3,
+                              points.size(), [&](QSqlQuery& q, int i) {
+        q.addBindValue(ids[points[i].first]);
+        q.addBindValue(points[i].second);
+        q.addBindValue(recipes[points[i].first].cookingPoints().at(points[i].second));
+    });
+    isOk = isOk && insertRows("INSERT INTO ProductsInRecipes (recipe_id, product_id, amound)", 3,
+                              ingredients.size(), [&](QSqlQuery& q, int i) {
+        const WeightedProduct& product = recipes[ingredients[i].first].products().at(ingredients[i].second);
+        q.addBindValue(ids[ingredients[i].first]);
+        q.addBindValue(product.product().id());
+        q.addBindValue(product.amound());
+    });
+    bool isCommitted = endTransaction(isOk);
+    sharedRecipeCatalog().invalidate();      // could be reloaded before the commit
+    return isCommitted ? ids : QVector<unsigned>();
 }
 
 void DatabaseModule::deleteRecipe(const RecipeEntity &recipe)
 {
-    QSqlQuery q;
-    q.prepare("DELETE FROM Recipes WHERE id=?");
+    QSqlQuery q = cachedQuery("DELETE FROM Recipes WHERE id=?");
     q.addBindValue(recipe.id());
     if(!q.exec()) {
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+        return;
     }
+    sharedRecipeCatalog().invalidate();
+    sharedEntityCache().remove(EntityCache::RecipeKind, recipe.id());
 }
 
 RecipeEntity DatabaseModule::recipe(unsigned recipeId)
 {
-    QSqlQuery q;
-    q.prepare("SELECT id, name FROM Recipes WHERE id=?");
-    q.addBindValue(recipeId);
-    if(!q.exec()){
-        m_errorList << "Error: in " << Q_FUNC_INFO << "!q!" << q.lastError().text();
-        ProductEntity();
+    RecipeEntity cached;
+    if (sharedEntityCache().find(int(recipeId), cached)) {
+        return cached;
     }
-    q.next();
-    if(!q.isValid()){
+    const quint64 generation = sharedEntityCache().generation();
+
+    QVector<RecipeEntity> found = hydrateRecipes("id = ?", {recipeId});
+    if(found.isEmpty()){
         qDebug() << "Error:" << Q_FUNC_INFO
                  << "In DB has no Recipe with id:" + QString::number(recipeId);
+        return RecipeEntity(recipeId, QString(), QVector<WeightedProduct>(), QStringList());
     }
-    QString recipeName = q.value("name").toString();
-    ///
-    /// Получение пордуктов для рецепта
-    ///
-    QSqlQuery q2;
-    q2.prepare("SELECT Products.id, Products.units, ProductsInRecipes.amound"
-                 "      FROM Products INNER JOIN ProductsInRecipes ON ProductsInRecipes.product_id = Products.id "
-                 "                                                      AND ProductsInRecipes.recipe_id = ?");
-    q2.addBindValue(recipeId);
-    if(!q2.exec()){
-        qDebug() << "Error: in " << Q_FUNC_INFO << "!q2!" << q2.lastError().text();
-        m_errorList << "Error: in " << Q_FUNC_INFO << "!q2!" << q2.lastError().text();
-    }
-    QVector<WeightedProduct> weightedProducts;
-    while(q2.next()){
-        auto productId = q2.value("id").toUInt();
-
-        WeightedProduct wproduct(this->product(productId) ,q2.value("amound").toFloat());
-        weightedProducts.push_back(wproduct);
-    }
-    ///
-    /// Получение пунктов приготовления
-    ///
-    QSqlQuery q3;
-    q3.prepare("SELECT CookingPoints.description "
-               "    FROM CookingPoints"
-               "    WHERE CookingPoints.recipe_id = ?");
-    q3.addBindValue(recipeId);
-    QStringList coockingPoints;
-    if(!q3.exec()){
-        m_errorList << "Error: in " << Q_FUNC_INFO << "!q3!" << q3.lastError().text();
-    }
-    while(q3.next()) {
-        coockingPoints << q3.value("description").toString();
-    }
-
-    return RecipeEntity(recipeId, recipeName, weightedProducts, coockingPoints);
+    sharedEntityCache().insert(found.first(), generation);
+    return found.first();
 }
 
 QVector<RecipeEntity> DatabaseModule::recipes()
 {
-    QVector<RecipeEntity> recipe;
-    ///
-    QSqlQuery q("SELECT id FROM Recipes");
-    if(!q.exec()) {
-        m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
-        return recipe;
+    return hydrateRecipes(QString(), QVariantList());
+}
+
+QVector<RecipeEntity> DatabaseModule::recipes(const QVector<unsigned> &ids)
+{
+    if (ids.isEmpty()) {
+        return QVector<RecipeEntity>();
     }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        RecipeEntity c = this->recipe(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            recipe.push_back(c);
+    QVector<unsigned> sorted = ids;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    QStringList placeholders;
+    for (int i = 0; i < IDS_PER_QUERY; ++i) {
+        placeholders << "?";
+    }
+    const QString condition = "id IN (" + placeholders.join(", ") + ")";
+
+    /// The last chunk repeats its last id to fill the placeholders
+    QVector<RecipeEntity> result;
+    for (int first = 0; first < sorted.size(); first += IDS_PER_QUERY) {
+        QVariantList binds;
+        for (int i = 0; i < IDS_PER_QUERY; ++i) {
+            binds << sorted[qMin(first + i, sorted.size() - 1)];
         }
+        result << hydrateRecipes(condition, binds);
     }
-    return recipe;
+    return result;
 }
 
 QVector<RecipeEntity> DatabaseModule::recipes(const QStringList &seachLine)
 {
-    QVector<RecipeEntity> recipes;
-    foreach (QString snp, seachLine) {
-        QSqlQuery q(QString(" SELECT id FROM Recipes     "
-                            " WHERE name LIKE '%%1%'       "
-                            ).arg(snp));
-        if(!q.exec()){
-            m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-            return recipes;
-        }
-
-        while(q.next()) {
-            auto prevErrorSize =  m_errorList.size();
-            RecipeEntity c = this->recipe(q.value("id").toInt());
-            auto avterErrorSize = m_errorList.size();
-            if(prevErrorSize == avterErrorSize) {
-                recipes.push_back(c);
-            }
-        }
-    }
-    return recipes;
+    QVariantList binds;
+    QString condition = recipeSearchCondition(seachLine, binds);
+    return hydrateRecipes(condition, binds);
 }
 
 QVector<RecipeEntity> DatabaseModule::recipes(QPair<float, float> interval, const char type)
 {
-    QVector<RecipeEntity> recipes;
-    ///
-    QString stype, prefix = " WHERE %1 BETWEEN %2 AND %3";
-    switch (type) {
-    case 'c': { stype = "carbohydrates"; } break;
-    case 'f': { stype = "fats"; } break;
-    case 'p': { stype = "proteins"; } break;
-    case 'k': { stype = "kkal"; } break;
-    default: {
-        stype = "";
-        prefix = "";
-    }
-    }
-    qDebug()<<stype<<interval<<"SELECT id FROM Recipes"
-                               "" + prefix.arg(stype).arg(interval.first).arg(interval.second);
+    QVariantList binds;
+    QString condition = recipeIntervalCondition(interval, type, binds);
+    return hydrateRecipes(condition, binds);
+}
 
-    QSqlQuery q("SELECT id FROM Recipes"
-                "" + prefix.arg(stype).arg(interval.first).arg(interval.second));
-    if(!q.exec()){
-        m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-        return recipes;
-    }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        RecipeEntity c = this->recipe(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            recipes.push_back(c);
-        }
-    }
+QVector<RecipeSummary> DatabaseModule::recipeSummaries(Page page) const
+{
+    return loadRecipeSummaries(QString(), QVariantList(), page);
+}
 
-    return recipes;
+QVector<RecipeSummary> DatabaseModule::recipeSummaries(const QStringList &seachLine, Page page) const
+{
+    QVariantList binds;
+    QString condition = recipeSearchCondition(seachLine, binds);
+    return loadRecipeSummaries(condition, binds, page);
 }
 
-void DatabaseModule::changeRecipeInformation(const RecipeEntity &newRecipe)
+QVector<RecipeSummary> DatabaseModule::recipeSummaries(QPair<float, float> interval, const char type, Page page) const
 {
-    for(auto p : newRecipe.products()) qDebug() << p.product().name();
-    //call this for testing to exists product
-    auto prevErrorSize =  m_errorList.size();
-    recipe(newRecipe.id());
-    auto avterErrorSize = m_errorList.size();
-    if(prevErrorSize != avterErrorSize) {
-        m_errorList << "Error:" << Q_FUNC_INFO << " Error with searching Recipe for update";
-        return;
+    QVariantList binds;
+    QString condition = recipeIntervalCondition(interval, type, binds);
+    return loadRecipeSummaries(condition, binds, page);
+}
+
+QVector<RecipeSummary> DatabaseModule::recipeSummaries(const RecipeCatalog::Filter &filter, Page page) const
+{
+    RecipeCatalog snapshot;
+    return loadedRecipeCatalog(snapshot).recipes(filter, page.afterId, page.limit);
+}
+
+QVector<RecipeSummary> DatabaseModule::searchRecipes(const QString &text, int limit) const
+{
+    if (SearchIndex::words(text).isEmpty()) {
+        return recipeSummaries(Page{0, limit});
     }
-    //QSqlQuery q("SELECT count(*) FROM Recipes WHERE id = ");
+    RecipeCatalog snapshot;
+    return loadedRecipeCatalog(snapshot).search(text, limit);
+}
 
-    //update RecipesTable
-    QSqlQuery updRecipesQ;
-    updRecipesQ.prepare(" UPDATE Recipes "
-                        " SET name = ? "
-                        " WHERE id = ? ");
+void DatabaseModule::changeRecipeInformation(RecipeEntity &newRecipe)
+{
+    /// The whole recipe is saved with one commit
+    if (!beginTransaction()) {
+        return;
+    }
+
+    //update RecipesTable, nothing is updated if the recipe was deleted or saved by another window
+    QSqlQuery updRecipesQ = cachedQuery(" UPDATE Recipes "
+                                        " SET name = ?, version = version + 1 "
+                                        " WHERE id = ? AND version = ? ");
     updRecipesQ.addBindValue(newRecipe.name());
     updRecipesQ.addBindValue(newRecipe.id());
+    updRecipesQ.addBindValue(newRecipe.version());
     if(!updRecipesQ.exec()){
         m_errorList << "Error:" << Q_FUNC_INFO << updRecipesQ.lastError().text();
+        endTransaction(false);
         return;
     }
-
-    //update ProductsInRecipes table
-    QSqlQuery dltProdInRecQ("DELETE FROM ProductsInRecipes WHERE recipe_id = " + QString::number(newRecipe.id()));
-    if(!dltProdInRecQ.exec()){
-        m_errorList << "Error:" << Q_FUNC_INFO << "DELETE ProductsInRecipes ERROR" << dltProdInRecQ.lastError().text();
+    if (updRecipesQ.numRowsAffected() == 0) {
+        m_errorList << "Error:" << Q_FUNC_INFO << notUpdatedReason("Recipes", newRecipe.id(), newRecipe.version());
+        endTransaction(false);
         return;
     }
-    if(!insertIntoProductsInRecipes(newRecipe.id(), newRecipe.products())) return;
 
-    //update CookingPoints table
-    QSqlQuery dltCookingQ("DELETE FROM CookingPoints WHERE recipe_id = " + QString::number(newRecipe.id()));
-    if(!dltCookingQ.exec()){
-        m_errorList << "Error:" << Q_FUNC_INFO << "DELETE CookingPoints ERROR" << dltCookingQ.lastError().text();
+    //update ProductsInRecipes and CookingPoints tables, only the rows that differ are written
+    if(!updateProductsInRecipes(newRecipe.id(), newRecipe.products())
+            || !updateCookingPoints(newRecipe.id(), newRecipe.cookingPoints())) {
+        endTransaction(false);
         return;
     }
-    if(!insertIntoCookingPoints(newRecipe.id(), newRecipe.cookingPoints())) return;
 
+    if (endTransaction(true)) {
+        newRecipe.setVersion(newRecipe.version() + 1);
+    }
+    sharedRecipeCatalog().invalidate();
+    sharedEntityCache().remove(EntityCache::RecipeKind, newRecipe.id());
 }
 
 unsigned DatabaseModule::addActivity(const ActivityEntity &ae)
 {
-    QSqlQuery q;
-    q.prepare("INSERT INTO Activities (type, kkal_m_km)"
-              "VALUES( ?, ? );");
+    QSqlQuery q = cachedQuery("INSERT INTO Activities (type, kkal_m_km)"
+                              "VALUES( ?, ? );");
     q.addBindValue(ae.type());
     q.addBindValue(ae.kkm());
     if(!q.exec()){
@@ -421,178 +1021,147 @@ unsigned DatabaseModule::addActivity(const ActivityEntity &ae)
     return q.lastInsertId().toUInt();
 }
 
+QVector<unsigned> DatabaseModule::addActivities(const QVector<ActivityEntity> &activities)
+{
+    QVector<unsigned> ids;
+    if (!beginTransaction()) {
+        return ids;
+    }
+    bool isOk = insertRows("INSERT INTO Activities (type, kkal_m_km)", 2,
+                           activities.size(), [&activities](QSqlQuery& q, int i) {
+        q.addBindValue(activities[i].type());
+        q.addBindValue(activities[i].kkm());
+    }, &ids);
+    return endTransaction(isOk) ? ids : QVector<unsigned>();
+}
+
 void DatabaseModule::deleteActivity(const ActivityEntity &activity)
 {
-    QSqlQuery q;
-    q.prepare("DELETE FROM Activities WHERE id=?");
+    QSqlQuery q = cachedQuery("DELETE FROM Activities WHERE id=?");
     q.addBindValue(activity.id());
     if(!q.exec()) {
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+        return;
     }
+    sharedEntityCache().remove(EntityCache::ActivityKind, activity.id());
 }
 
 ActivityEntity DatabaseModule::activity(unsigned id)
 {
-    QSqlQuery q;
-    q.prepare("SELECT * FROM Activities WHERE id=?");
+    ActivityEntity cached;
+    if (sharedEntityCache().find(int(id), cached)) {
+        return cached;
+    }
+    const quint64 generation = sharedEntityCache().generation();
+
+    QSqlQuery q = cachedQuery("SELECT " + ACTIVITY_COLUMNS + " FROM Activities WHERE id=?");
     q.addBindValue(id);
     if(!q.exec()){
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
-        ActivityEntity();
+        return ActivityEntity();
     }
     ///
-    q.next();
-    ///
-    if(!q.isValid()){
+    if(!q.next()){
         qDebug() << "Error:" << Q_FUNC_INFO
                  << "In DB has no Activity with id:" + QString::number(id);
+        return ActivityEntity(id, QString(), 0);
     }
     ///
-    QString type = q.value("type").toString();
-    float kkm =  q.value("kkal_m_km").toFloat();
-
-    return ActivityEntity(id, type, kkm);
+    cached = activityFromRow(q);
+    q.finish();
+    sharedEntityCache().insert(cached, generation);
+    return cached;
 }
 
-QVector<ActivityEntity> DatabaseModule::activities()
+QVector<ActivityEntity> DatabaseModule::activities(Page page)
 {
-    QVector<ActivityEntity> activities;
-    ///
-    QSqlQuery q("SELECT id FROM Activities");
-    if(!q.exec()) {
-        m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
-        return activities;
-    }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        ActivityEntity c = this->activity(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            activities.push_back(c);
-        }
-    }
-    return activities;
+    return loadActivities(QString(), QVariantList(), page);
 }
 
-QVector<ActivityEntity> DatabaseModule::activities(const QStringList &seachLine)
+QVector<ActivityEntity> DatabaseModule::activities(const QStringList &seachLine, Page page)
 {
-    QVector<ActivityEntity> activities;
-    foreach (QString snp, seachLine) {
-        QSqlQuery q(QString(" SELECT id FROM Activities     "
-                            " WHERE type LIKE '%1%'       "
-                            ).arg(snp));
-        if(!q.exec()){
-            m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-            return activities;
-        }
-        while(q.next()) {
-            auto prevErrorSize =  m_errorList.size();
-            ActivityEntity c = this->activity(q.value("id").toInt());
-            auto avterErrorSize = m_errorList.size();
-            if(prevErrorSize == avterErrorSize) {
-                activities.push_back(c);
-            }
-        }
+    QStringList words = paddedWords(seachLine.filter(QRegExp("\\S")));
+    if (words.isEmpty()) {
+        return QVector<ActivityEntity>();       // nothing is searched for, nothing is found
     }
-    return activities;
+    QVariantList binds;
+    foreach (const QString& word, words) {
+        binds << word + "%";
+    }
+    return loadActivities(likeCondition({"type"}, words.size()), binds, page);
 }
 
-QVector<ActivityEntity> DatabaseModule::activities(QPair<float, float> kkmInterval)
+QVector<ActivityEntity> DatabaseModule::activities(QPair<float, float> kkmInterval, Page page)
 {
-    QVector<ActivityEntity> activities;
-
-    QSqlQuery q(QString("SELECT id FROM Activities "
-                        "WHERE kkal_m_km BETWEEN %1 AND %2")
-                .arg(kkmInterval.first)
-                .arg(kkmInterval.second));
-    if(!q.exec()){
-        m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
-        return activities;
-    }
-    while(q.next()) {
-        auto prevErrorSize =  m_errorList.size();
-        ActivityEntity c = this->activity(q.value("id").toInt());
-        auto avterErrorSize = m_errorList.size();
-        if(prevErrorSize == avterErrorSize) {
-            activities.push_back(c);
-        }
-    }
-
-    return activities;
+    return loadActivities("kkal_m_km BETWEEN ? AND ?", {kkmInterval.first, kkmInterval.second}, page);
 }
 
-void DatabaseModule::changeActivityInformation(const ActivityEntity &newActivity)
+void DatabaseModule::changeActivityInformation(ActivityEntity &newActivity)
 {
-    //call this for testing to exists product
-    auto prevErrorSize =  m_errorList.size();
-    activity(newActivity.id());
-    auto avterErrorSize = m_errorList.size();
-    if(prevErrorSize != avterErrorSize) {
-        m_errorList << "Error:" << Q_FUNC_INFO << " Error with searching activity for update";
-        return;
-    }
-
-    QSqlQuery q;
-    q.prepare("UPDATE Activities "
-              "SET type = ?, kkal_m_km = ? "
-              "WHERE id = ?"
-              );
-    qDebug() << newActivity.type() << newActivity.kkm() << newActivity.id();
+    QSqlQuery q = cachedQuery("UPDATE Activities "
+                              "SET type = ?, kkal_m_km = ?, version = version + 1 "
+                              "WHERE id = ? AND version = ?"
+                              );
     q.addBindValue(newActivity.type());
     q.addBindValue(newActivity.kkm());
     q.addBindValue(newActivity.id());
+    q.addBindValue(newActivity.version());
     if(!q.exec()) {
         m_errorList << "Error:" << Q_FUNC_INFO << q.lastError().text();
         return;
     }
+    if (q.numRowsAffected() == 0) {
+        m_errorList << "Error:" << Q_FUNC_INFO << notUpdatedReason("Activities", newActivity.id(), newActivity.version());
+        return;
+    }
+    newActivity.setVersion(newActivity.version() + 1);
+    sharedEntityCache().remove(EntityCache::ActivityKind, newActivity.id());
 }
 
 bool DatabaseModule::addExaminationAndSetID(Examination &examination)
 {
-    QString strValues = "client_id, is_full_examination, date";
-    QString questionMSequense;
-
-    QVector<FormField> fieldValues = examination.fields();
-    foreach (const FormField& field, fieldValues) {
-        strValues += ", " + field.name();
-        questionMSequense += ", ?";
+    if (!beginTransaction()) {
+        return false;
     }
+    bool isOk = true;
 
-    QSqlQuery q;
-    q.prepare("INSERT INTO Examinations (" + strValues + ")"
-              "VALUES( ?, ?, ?" + questionMSequense + " );");
+    QSqlQuery q = cachedQuery("INSERT INTO Examinations (client_id, is_full_examination, date) VALUES(?, ?, ?)");
     q.addBindValue(examination.client().id());
     q.addBindValue(examination.isFullExamination());
     q.addBindValue(examination.date().toString(Qt::ISODate));
-    foreach (const FormField& field, fieldValues) {
-        q.addBindValue(field.value());
-    }
     if(!q.exec()) {
         qDebug() << "Error: in addExamination(...)\n\t"
                  <<  q.lastError().text();
+        isOk = false;
+    }
+    int id = q.lastInsertId().toInt();
+
+    isOk = isOk && insertIntoExaminationValues(id, examination.fields());
+    if (!endTransaction(isOk)) {
         return false;
     }
 
-    examination.setId(q.lastInsertId().toInt());
+    examination.setId(id);
+    sharedExaminationTrends().merge(examination.client().id(), examination);
 
     return true;
 }
 
 void DatabaseModule::deleteExamination(const Examination &examination)
 {
-    QSqlQuery q;
-    q.prepare("DELETE FROM Examinations WHERE id=?");
+    QSqlQuery q = cachedQuery("DELETE FROM Examinations WHERE id=?");
     q.addBindValue(examination.id());
     if(!q.exec()) {
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+        return;
     }
+    sharedExaminationTrends().removeExamination(examination.client().id(), examination.id());
 }
 
 bool DatabaseModule::addClientAndSetID(Client &client)
 {
-    QSqlQuery q;
-    q.prepare("INSERT INTO Clients (surname, name, patronymic, birth_date, gender, age, tel_number)"
-              "VALUES( ?, ?, ?, ?, ?, ?, ? );");
+    QSqlQuery q = cachedQuery("INSERT INTO Clients (surname, name, patronymic, birth_date, gender, age, tel_number)"
+                              "VALUES( ?, ?, ?, ?, ?, ?, ? );");
     q.addBindValue(client.surname());
     q.addBindValue(client.name());
     q.addBindValue(client.patronymic());
@@ -612,27 +1181,23 @@ bool DatabaseModule::addClientAndSetID(Client &client)
 
 void DatabaseModule::deleteClient(const Client &client)
 {
-    QSqlQuery q;
-    q.prepare("DELETE FROM Clients WHERE id=?");
+    QSqlQuery q = cachedQuery("DELETE FROM Clients WHERE id=?");
     q.addBindValue(client.id());
     if(!q.exec()) {
         m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+        return;
     }
+    sharedEntityCache().remove(EntityCache::ClientKind, client.id());
+    sharedExaminationTrends().remove(client.id());
 }
 
-bool DatabaseModule::changeClientInformation(const Client &client)
+bool DatabaseModule::changeClientInformation(Client &client)
 {
-    bool isFoundClient = false;
-    this->client(client.id(), isFoundClient);
-    if (!isFoundClient){
-        return false;
-    }
-
-    QSqlQuery q;
-    q.prepare("UPDATE Clients "
-              "SET surname = ?, name = ?, patronymic = ?, birth_date = ?, gender = ?, age = ?, tel_number = ? "
-              "WHERE id = ?"
-              );
+    QSqlQuery q = cachedQuery("UPDATE Clients "
+                              "SET surname = ?, name = ?, patronymic = ?, birth_date = ?, gender = ?, age = ?, tel_number = ?, "
+                              "version = version + 1 "
+                              "WHERE id = ? AND version = ?"
+                              );
     q.addBindValue(client.surname());
     q.addBindValue(client.name());
     q.addBindValue(client.patronymic());
@@ -641,19 +1206,32 @@ bool DatabaseModule::changeClientInformation(const Client &client)
     q.addBindValue(client.age());
     q.addBindValue(client.telNumber());
     q.addBindValue(client.id());
+    q.addBindValue(client.version());
 
     if(!q.exec()) {
         qDebug() << "Error: in changeClientInformation(...)\n\t" <<  q.lastError().text();
         return false;
     }
+    if (q.numRowsAffected() == 0) {
+        qDebug() << "Error:" << Q_FUNC_INFO << notUpdatedReason("Clients", client.id(), client.version());
+        return false;
+    }
+    client.setVersion(client.version() + 1);
+    sharedEntityCache().remove(EntityCache::ClientKind, client.id());
 
     return true;
 }
 
 Client DatabaseModule::client(int id, bool& isOk) const
 {
-    QSqlQuery q;
-    q.prepare("SELECT * FROM Clients WHERE id=?");
+    Client cached;
+    if (sharedEntityCache().find(id, cached)) {
+        isOk = true;
+        return cached;
+    }
+    const quint64 generation = sharedEntityCache().generation();
+
+    QSqlQuery q = cachedQuery("SELECT " + CLIENT_COLUMNS + " FROM Clients WHERE id=?");
     q.addBindValue(id);
     if(!q.exec()) {
         qDebug() << "Error: DatabaseModule::client(int, bool)";
@@ -661,193 +1239,213 @@ Client DatabaseModule::client(int id, bool& isOk) const
         return Client();
     }
 
-    q.next();
-
-    if(!q.isValid()){
+    if(!q.next()){
         qDebug() << "Error:" << Q_FUNC_INFO
                  << "In DB has no Client with id:" + QString::number(id);
         isOk = false;
         return Client();
     }
 
-    QString surname = q.value("surname").toString();
-    QString name = q.value("name").toString();
-    QString patronymic = q.value("patronymic").toString();
-    QChar gender = q.value("gender").toString().at(0);
-    QDate birthDate = QDate::fromString(q.value("birth_date").toString(), Qt::ISODate);
-    short age = q.value("age").toInt();
-    QString telNumber = q.value("tel_number").toString();
-
     isOk = true;
 
-    return Client(id, name, surname, patronymic, birthDate, gender, age, telNumber);
+    cached = clientFromRow(q);
+    q.finish();
+    sharedEntityCache().insert(cached, generation);
+    return cached;
 }
 
 QVector<Client> DatabaseModule::clients(const QString& snp) const
 {
-    QStringList snpList = snp.toLower().split(QRegExp("[\\s,.]+"), QString::SkipEmptyParts);
-
-    QVector<Client> clients;
-
-    foreach (QString snp, snpList) {
-        snp[0] = snp[0].toUpper();
-
-        QSqlQuery q(QString(" SELECT id FROM Clients       "
-                            " WHERE surname LIKE '%1%'    "
-                            "    OR name LIKE '%2%'       "
-                            "    OR patronymic LIKE '%3%' "
-                            ).arg(snp).arg(snp).arg(snp));
-
-        if(!q.exec()){
-            qDebug() << "Error:" << Q_FUNC_INFO
-                     << "Wrong condition";
-            qDebug() << q.lastError().text();
-            return clients;
-        }
+    QVariantList binds;
+    QString condition = clientSearchCondition(snp, binds);
+    if (condition.isEmpty()) {
+        return clients();
+    }
 
-        while(q.next()) {
-            bool isOk;
-            Client client = this->client(q.value("id").toInt(), isOk);
-            clients.push_back(client);
-        }
+    QSqlQuery q = cachedQuery("SELECT " + CLIENT_COLUMNS + " FROM Clients WHERE " + condition);
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    if(!q.exec()){
+        qDebug() << "Error:" << Q_FUNC_INFO
+                 << "Wrong condition";
+        qDebug() << q.lastError().text();
+        return QVector<Client>();
     }
 
-    return clients;
+    return materialize<Client>(q, clientFromRow);
 }
 
 QVector<Client> DatabaseModule::clients() const
 {
-    QVector<Client> clients;
-
-    QSqlQuery q("SELECT id FROM Clients");
+    QSqlQuery q = cachedQuery("SELECT " + CLIENT_COLUMNS + " FROM Clients");
     if(!q.exec()) {
         qDebug() << "Error: DatabaseModule::clients()";
-        return clients;
+        return QVector<Client>();
     }
 
-    while(q.next()) {
-        bool isOk;
-        Client c = this->client(q.value("id").toInt(), isOk);
-        if(isOk) {
-            clients.push_back(c);
-        }
-    }
+    return materialize<Client>(q, clientFromRow);
+}
 
-    return clients;
+QVector<ClientSummary> DatabaseModule::clientSummaries(Page page) const
+{
+    return clientSummaries(QString(), page);
 }
 
-Examination DatabaseModule::examination(int id, bool& isOk, Client client) const
+QVector<ClientSummary> DatabaseModule::clientSummaries(const QString &snp, Page page) const
 {
-    Examination examination;
+    QVariantList binds;
+    QString condition = clientSearchCondition(snp, binds);
 
-    QSqlQuery q;
-    q.prepare("SELECT * FROM Examinations WHERE id=?");
-    q.addBindValue(id);
-    if(!q.exec()) {
-        qDebug() << "Error: DatabaseModule::examination(int, bool)";
-        isOk = false;
-        return examination;
+    QSqlQuery q = cachedQuery("SELECT id, surname, name, patronymic FROM Clients" + pagedWhere(condition, "id"));
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
     }
-    q.next();
-
-    if (!client.isInit()) {
-        client = this->client(q.value("client_id").toInt(), isOk);
-        if (!isOk) {
-            qDebug() << "Error: DatabaseModule::examination(int, bool)"
-                     << "'client' information doesn't found";
-            return examination;
-        }
+    q.addBindValue(page.afterId);
+    q.addBindValue(page.limit);
+    if(!q.exec()){
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        return QVector<ClientSummary>();
     }
-    examination.setClient(client);
 
-    examination.setId(q.value("id").toInt());
-    examination.setIsFullExamination(q.value("is_full_examination").toBool());
-    examination.setDate(QDateTime::fromString(q.value("date").toString(), Qt::ISODate));
+    return materialize<ClientSummary>(q, [](const QSqlQuery& row) {
+        return ClientSummary{ row.value(0).toInt(), row.value(1).toString(),
+                              row.value(2).toString(), row.value(3).toString() };
+    });
+}
+
+Examination DatabaseModule::examination(int id, bool& isOk, Client client, ExaminationProjection projection) const
+{
+    QVector<Examination> examinations = loadExaminations("e.id=?", { id }, client, projection);
+    isOk = !examinations.isEmpty();
+    if (!isOk) {
+        qDebug() << "Error: DatabaseModule::examination(int, bool)"
+                 << "examination or its 'client' information doesn't found";
+        return Examination();
+    }
+    return examinations.first();
+}
 
-    foreach (FormField field, examination.fields()) {
-        QString fieldValue = q.value(field.name()).toString();
-        examination.setFieldValue(field.name(), fieldValue);
+QVector<Examination> DatabaseModule::examinations(Client client, ExaminationProjection projection) const
+{
+    if (client.isInit()) {
+        return loadExaminations("e.client_id=?", { client.id() }, client, projection);
     }
+    return loadExaminations(QString(), QVariantList(), client, projection);
+}
 
-    isOk = true;
-    return examination;
+QVector<Examination> DatabaseModule::examinations(QDate from, QDate to, ExaminationProjection projection) const
+{
+    QDateTime fromT(from), toT(to, QTime(23, 59, 59));
+
+    return loadExaminations("e.date BETWEEN ? AND ?",
+                            { fromT.toString(Qt::ISODate), toT.toString(Qt::ISODate) },
+                            Client(), projection);
 }
 
-QVector<Examination> DatabaseModule::examinations(Client client) const
+QVector<ExaminationSummary> DatabaseModule::examinationSummaries(Page page) const
 {
-    QVector<Examination> examinations;
+    return loadExaminationSummaries(QString(), QVariantList(), page);
+}
 
-    QString addQuery = client.isInit() ? "WHERE client_id=" + QString::number(client.id())
-                                       : "";
-    QSqlQuery q("SELECT id FROM Examinations " + addQuery);
-    if(!q.exec()) {
-        qDebug() << "DatabaseModule::examinations(const Client &)";
-        return examinations;
+QVector<ExaminationSummary> DatabaseModule::examinationSummaries(const QString &snp, Page page) const
+{
+    QVariantList binds;
+    QString condition = clientSearchCondition(snp, binds);
+    if (condition.isEmpty()) {
+        return examinationSummaries(page);
     }
+    return loadExaminationSummaries("e.client_id IN (SELECT id FROM Clients WHERE " + condition + ")", binds, page);
+}
 
-    while(q.next()) {
-        bool isOk;
-        Examination exm = this->examination(q.value("id").toInt(), isOk, client);
-        if (isOk) {
-            examinations.push_back(exm);
-        }
-    }
+QVector<ExaminationSummary> DatabaseModule::examinationSummaries(QDate from, QDate to, Page page) const
+{
+    QDateTime fromT(from), toT(to, QTime(23, 59, 59));
 
-    return examinations;
+    return loadExaminationSummaries("e.date BETWEEN ? AND ?",
+                                    { fromT.toString(Qt::ISODate), toT.toString(Qt::ISODate) }, page);
 }
 
-QVector<Examination> DatabaseModule::examinations(QDate from, QDate to) const
+bool DatabaseModule::changeExaminationInformation(Examination &examination)
 {
-    QDateTime fromT(from), toT(to, QTime(23, 59, 59));
-    QVector<Examination> examinations;
+    //without id, client_id, is_full_examination, date
+    if (!beginTransaction()) {
+        return false;
+    }
+    bool isOk = true;
 
-    QSqlQuery q;
-    q.prepare("SELECT id FROM Examinations WHERE date BETWEEN ? AND ?");
-    q.addBindValue(fromT.toString(Qt::ISODate));
-    q.addBindValue(toT.toString(Qt::ISODate));
-    if(!q.exec()) {
-        qDebug() << "DatabaseModule::examinations(QDate from, QDate to)";
-        return examinations;
+    /// Claims the version first, nothing is written if the examination was deleted or saved by another window
+    QSqlQuery version = cachedQuery("UPDATE Examinations SET version = version + 1 WHERE id = ? AND version = ?");
+    version.addBindValue(examination.id());
+    version.addBindValue(examination.version());
+    if (!version.exec()) {
+        qDebug() << "Error:" << Q_FUNC_INFO << version.lastError().text();
+        isOk = false;
+    }
+    if (isOk && version.numRowsAffected() == 0) {
+        qDebug() << "Error:" << Q_FUNC_INFO << notUpdatedReason("Examinations", examination.id(), examination.version());
+        isOk = false;
     }
 
-    while(q.next()) {
-        bool isOk;
-        Examination exm = this->examination(q.value("id").toInt(), isOk);
-        if (isOk) {
-            examinations.push_back(exm);
-        }
+    QSqlQuery q = cachedQuery("DELETE FROM ExaminationValues WHERE examination_id = ?");
+    q.addBindValue(examination.id());
+    if(isOk && !q.exec()) {
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        isOk = false;
     }
+    isOk = isOk && insertIntoExaminationValues(examination.id(), examination.fields());
 
-    return examinations;
+    if (!endTransaction(isOk)) {
+        return false;
+    }
+    examination.setVersion(examination.version() + 1);
+    sharedExaminationTrends().remove(examination.client().id());    // the edited copy may have another date than the stored one
+    return true;
 }
 
-bool DatabaseModule::changeExaminationInformation(Examination &examination)
+ExaminationTrends DatabaseModule::examinationTrends(const Client &client) const
 {
-    bool isFounExaination = false;
-    this->examination(examination.id(), isFounExaination, examination.client());
-    if (!isFounExaination){
-        return false;
+    ExaminationTrends trends;
+    if (sharedExaminationTrends().find(client.id(), trends)) {
+        return trends;
     }
+    const quint64 generation = sharedExaminationTrends().generation();
 
-    QStringList queryFields; //without id, client_id, is_full_examination, date
-
-    for (FormField field : examination.fields()) {
-        queryFields << QString("%1 = '%2'")
-                .arg(field.name())
-                .arg(field.value());
+    QStringList fields;
+    for (int field : ExaminationTrends::fieldNumbers()) {
+        fields << QString::number(field);
     }
-    QSqlQuery q;
-    q.prepare("UPDATE Examinations "
-              "SET " + queryFields.join(", ") +
-              "WHERE id = ?");
-    q.addBindValue(examination.id());
+    QSqlQuery q = cachedQuery("SELECT " + qualifiedColumns(EXAMINATION_VALUE_COLUMNS, "v") + ", e.date"
+                              " FROM ExaminationValues v JOIN Examinations e ON e.id = v.examination_id"
+                              " WHERE e.client_id = ? AND v.field IN (" + fields.join(", ") + ")"
+                              " ORDER BY e.date, e.id");
+    q.addBindValue(client.id());
     if(!q.exec()) {
-        qDebug() << q.lastQuery();
         qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
-        return false;
+        return trends;
+    }
+
+    const int dateColumn = ValueText + 1;
+    while (q.next()) {
+        /// Only the values of the String fields are parsed, the numbers are read typed
+        bool isNumber = true;
+        double value = 0;
+        if (!q.isNull(ValueReal)) {
+            value = q.value(ValueReal).toDouble();
+        } else if (!q.isNull(ValueInt)) {
+            value = q.value(ValueInt).toDouble();
+        } else {
+            value = Examination::toReal(q.value(ValueText).toString(), &isNumber);
+        }
+        if (isNumber) {
+            trends.add(q.value(ValueExaminationId).toInt(),
+                       QDateTime::fromString(q.value(dateColumn).toString(), Qt::ISODate),
+                       q.value(ValueField).toInt(), value);
+        }
     }
 
-    return true;
+    sharedExaminationTrends().insert(client.id(), trends, generation);
+    return trends;
 }
 
 bool DatabaseModule::importDB(const QString &fileName)
@@ -856,16 +1454,38 @@ bool DatabaseModule::importDB(const QString &fileName)
         return false;
     }
 
+    /// Compiled statements belong to the current file
+    clearStatementCache();
+
     /// Is it possible to read the file?
     _db.setDatabaseName(fileName);
-    if (!_db.open()) {
+    bool isReadable = _db.open();
+    if (!isReadable) {
         qDebug() << "Warning:" << Q_FUNC_INFO
                  << _db.lastError().text();
+    } else {
+        /// Can the file be upgraded to the current schema? Nothing is written to it
+        SchemaMigrator migrator(_db);
+        for (const auto& migration : schemaMigrations()) {
+            migrator.addMigration(migration);
+        }
+        isReadable = migrator.migrate(true);
+        for (const QString& line : migrator.reportText()) {
+            qDebug() << "Info:" << Q_FUNC_INFO << line;
+        }
+    }
+    if (!isReadable) {
         /// If the new new DB file could not be seted
         /// set the previous DB file
+        _db.close();
         _db.setDatabaseName(_DB_NAME);
+        _db.open();
+        applyConnectionProfile();
         return false;
     }
+    /// Closing the last connection checkpoints the WAL of the imported file,
+    /// so the main file alone holds all of its data
+    _db.close();
 
     if(QFile::exists(_DB_NAME)){
         if(!QFile::remove(_DB_NAME)){
@@ -873,6 +1493,9 @@ bool DatabaseModule::importDB(const QString &fileName)
                      <<  "Old file can not be deleted";
             return false;
         }
+        /// WAL files of the old database must not be applied to the new one
+        QFile::remove(_DB_NAME + "-wal");
+        QFile::remove(_DB_NAME + "-shm");
     } else {
         qDebug() << "Warning:" << Q_FUNC_INFO
                  << "The old file is not exist";
@@ -885,14 +1508,30 @@ bool DatabaseModule::importDB(const QString &fileName)
     }
 
     _db.setDatabaseName(_DB_NAME);
-
-    //DatabaseModule();
+    if (!_db.open()) {
+        qDebug() << "Error:" << Q_FUNC_INFO
+                 << _db.lastError().text();
+        return false;
+    }
+    applyConnectionProfile();
+    upgradeSchema();
+    sharedProductCatalog().invalidate();
+    sharedRecipeCatalog().invalidate();
+    sharedEntityCache().clear();
+    sharedExaminationTrends().clear();
 
     return true;
 }
 
 bool DatabaseModule::exportDB(const QString &fileName)
 {
+    /// Moves the pages from the WAL file into the main file before copying it
+    QSqlQuery checkpoint(_db);
+    if (!checkpoint.exec("PRAGMA wal_checkpoint(TRUNCATE)")) {
+        qDebug() << "Warning:" << Q_FUNC_INFO
+                 << checkpoint.lastError().text();
+    }
+
     if(!QFile::copy(_DB_NAME, fileName)){
         qDebug() << "Error:" << Q_FUNC_INFO
                  <<  "New file can not be copied";
@@ -914,8 +1553,54 @@ QStringList DatabaseModule::unwatchedWorkError()
     return ret;
 }
 
+void DatabaseModule::applyConnectionProfile()
+{
+    QSettings settings(_DB_CONFIG_NAME, QSettings::IniFormat);
+    settings.beginGroup("sqlite");
+
+    /// Order matters: journal_mode can not be changed inside a transaction
+    /// and mmap_size has to be set before the first read of the pages
+    const QVector<QPair<QString, QString>> pragmas = {
+        { "journal_mode", settings.value("journal_mode", "WAL").toString() },
+        { "synchronous",  settings.value("synchronous",  "NORMAL").toString() },
+        { "temp_store",   settings.value("temp_store",   "MEMORY").toString() },
+        { "mmap_size",    settings.value("mmap_size",    268435456).toString() },   // 256 MiB
+        { "cache_size",   settings.value("cache_size",   -32768).toString() },      // negative - KiB, 32 MiB
+        { "foreign_keys", settings.value("foreign_keys", "ON").toString() },
+    };
+    settings.endGroup();
+
+    /// The entities read by id, shared by all the connections
+    sharedEntityCache().setBudget(settings.value("cache/entity_budget", EntityCache::DEFAULT_BUDGET).toInt());
+
+    QRegExp validValue("[A-Za-z0-9-]+");
+    QSqlQuery q(_db);
+    m_connectionProfile.clear();
+    for (const auto& pragma : pragmas) {
+        if (!validValue.exactMatch(pragma.second)
+                || !q.exec(QString("PRAGMA %1 = %2").arg(pragma.first, pragma.second))) {
+            qDebug() << "Warning:" << Q_FUNC_INFO
+                     << "Can not set" << pragma.first << "to" << pragma.second << q.lastError().text();
+        }
+        /// Read back, SQLite silently ignores unsupported values
+        if (q.exec("PRAGMA " + pragma.first) && q.next()) {
+            m_connectionProfile << pragma.first + "=" + q.value(0).toString();
+        }
+    }
+    q.finish();
+
+    qDebug() << "Info:" << Q_FUNC_INFO << "SQLite profile:" << m_connectionProfile.join(", ");
+}
+
+QStringList DatabaseModule::connectionProfile() const
+{
+    return m_connectionProfile;
+}
+
 void DatabaseModule::initEmptyDB()
 {
+    clearStatementCache();
+
     QFile file(_DB_NAME);
     QDir dir;
     dir.mkdir("./database/");
@@ -928,145 +1613,658 @@ void DatabaseModule::initEmptyDB()
     _db.setDatabaseName(_DB_NAME);
 
 
+    /// The tables are created by the schema migrations
     if (!_db.open()) {
         qDebug() << "Error: " << Q_FUNC_INFO
                  << _db.lastError().text();
         return;
     }
-    QStringList querys;
+}
 
-    /*
-     * Clients table
-    */
-    querys << QString("CREATE TABLE `Clients` ("
-                      "`id`           INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE,"
-                      "`surname`      TEXT NOT NULL,"
-                      "`name`         TEXT NOT NULL,"
-                      "`patronymic`	TEXT NOT NULL,"
-                      "`birth_date`	TEXT NOT NULL,"
-                      "`gender`       TEXT NOT NULL,"
-                      "`age`          INTEGER NOT NULL,"
-                      "`tel_number`	TEXT NOT NULL"
-                      ");"
-                      );
-    /*
-     * Examination table
-    */
-    QString formfieldNames;
-    Examination exm;
-    foreach (FormField field, exm.fields()) {
-        formfieldNames += QString(" `%1` TEXT, ").arg(field.name());
+void DatabaseModule::upgradeSchema()
+{
+    SchemaMigrator migrator(_db);
+    for (const auto& migration : schemaMigrations()) {
+        migrator.addMigration(migration);
     }
-    querys << QString("CREATE TABLE `Examinations` ("
-                      "`id`	INTEGER PRIMARY KEY AUTOINCREMENT UNIQUE,"
-                      "`client_id`	INTEGER NOT NULL,"
-                      "`is_full_examination`	INTEGER NOT NULL,"
-                      "`date`	TEXT NOT NULL,"
-                      + formfieldNames +
-                      "FOREIGN KEY(`client_id`) REFERENCES `Clients`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
-                      ");"
-                      );
-    /*
-     * Activities table
-    */
-    querys << QString("CREATE TABLE `Activities` ("
-                      "`id`        INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
-                      "`type`      TEXT NOT NULL UNIQUE,"
-                      "`kkal_m_km`	REAL NOT NULL"
-                      ");"
-                      );
-    /*
-     * CookingPoints table
-    */
-    querys << QString("CREATE TABLE `CookingPoints` ("
-                      "`recipe_id`     INTEGER NOT NULL,"
-                      "`point_num`     INTEGER NOT NULL,"
-                      "`description`	TEXT NOT NULL,"
-                      "    FOREIGN KEY(`recipe_id`) REFERENCES `Recipes`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
-                      ");"
-                      );
-    /*
-     * Products table
-    */
-    querys << QString("CREATE TABLE `Products` ("
-                      "`id`	INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
-                      "`name`	TEXT NOT NULL UNIQUE,"
-                      "`proteins`	REAL NOT NULL,"
-                      "`fats`	REAL NOT NULL,"
-                      "`carbohydrates`	REAL NOT NULL,"
-                      "`kkal`	REAL NOT NULL,"
-                      "`description`	TEXT NOT NULL,"
-                      "`units`	INTEGER NOT NULL"
-                      ");"
-                      );
-    /*
-     * ProductsInRecipes table
-    */
-    querys << QString("CREATE TABLE `ProductsInRecipes` ("
-                      "`recipe_id`	INTEGER NOT NULL,"
-                      "`product_id`	INTEGER NOT NULL,"
-                      "`amound`	REAL NOT NULL,"
-                      "FOREIGN KEY(`product_id`) REFERENCES `Products`(`id`) ON UPDATE CASCADE,"
-                      "FOREIGN KEY(`recipe_id`) REFERENCES `Recipes`(`id`) ON DELETE CASCADE ON UPDATE CASCADE"
-                      ");"
-                      );
-    /*
-     * Recipes table
-    */
-    querys << QString("CREATE TABLE `Recipes`("
-                      "`id`	INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT UNIQUE,"
-                      "`name`	TEXT NOT NULL,"
-                      "`proteins`	REAL NOT NULL,"
-                      "`fats`	REAL NOT NULL,"
-                      "`carbohydrates`	REAL NOT NULL,"
-                      "`kcal`	REAL NOT NULL"
-                      ");"
-                      );
-    QSqlQuery query;
-    for (auto q : querys){
-        if(!query.exec(q)){
-            qDebug() << "Error:" << Q_FUNC_INFO
-                     << "DB was not init new empty table. ";
-            qDebug() << "QUERY: --------";
-            qDebug() << q;
-            qDebug() << "---------------";
-            return;
+
+    if (!migrator.migrate()) {
+        m_errorList << "Error: in " << Q_FUNC_INFO << "Schema can not be upgraded" << migrator.reportText();
+    }
+    for (const QString& line : migrator.reportText()) {
+        qDebug() << "Info:" << Q_FUNC_INFO << line;
+    }
+    detectFullTextSearch();
+}
+
+void DatabaseModule::detectFullTextSearch()
+{
+    /// The full text step is optional, SQLite may be built without FTS5
+    m_isFullTextSearch = false;
+    QSqlQuery query(_db);
+    if (query.exec("SELECT count(*) FROM sqlite_master WHERE type='table'"
+                   " AND name IN ('ProductsFts', 'RecipesFts', 'ClientsFts')") && query.next()) {
+        m_isFullTextSearch = query.value(0).toInt() == 3;
+    }
+    if (!m_isFullTextSearch) {
+        qDebug() << "Warning:" << Q_FUNC_INFO
+                 << "Full text search is not available, LIKE is used";
+    }
+}
+
+DatabaseModule::StatementCacheStats DatabaseModule::statementCacheStats() const
+{
+    StatementCacheStats stats;
+    stats.hits = m_statementCacheHits;
+    stats.misses = m_statementCacheMisses;
+    stats.size = m_statements.size();
+    return stats;
+}
+
+EntityCache::Stats DatabaseModule::entityCacheStats() const
+{
+    return sharedEntityCache().stats();
+}
+
+QSqlQuery DatabaseModule::cachedQuery(const QString &sql) const
+{
+    auto it = m_statements.find(sql);
+    if (it != m_statements.end() && !isBeingRead(*it)) {
+        ++m_statementCacheHits;
+        /// Nobody reads it, resetting it loses nothing; the caller binds all values again
+        it->finish();
+        return *it;
+    }
+
+    ++m_statementCacheMisses;
+    QSqlQuery q(_db);
+    q.setForwardOnly(true);
+    if (!q.prepare(sql) || it != m_statements.end()) {
+        return q;                       // re-entrant use, e.g. a nested load, gets a handle of its own
+    }
+    if (m_statements.size() >= STATEMENT_CACHE_CAPACITY) {
+        evictStatements();
+    }
+    m_statements.insert(sql, q);
+    return q;
+}
+
+void DatabaseModule::evictStatements() const
+{
+    for (auto it = m_statements.begin(); it != m_statements.end(); ) {
+        if (isBeingRead(*it)) {
+            ++it;
+        } else {
+            it->finish();
+            it = m_statements.erase(it);
+        }
+    }
+}
+
+void DatabaseModule::clearStatementCache() const
+{
+    for (QSqlQuery& q : m_statements) {
+        q.finish();
+    }
+    m_statements.clear();
+}
+
+QVector<ProductEntity> DatabaseModule::loadProducts(const QString &condition, const QVariantList &binds, Page page)
+{
+    QSqlQuery q = cachedQuery("SELECT " + PRODUCT_COLUMNS + " FROM Products" + pagedWhere(condition, "id"));
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    q.addBindValue(page.afterId);
+    q.addBindValue(page.limit);
+    if(!q.exec()){
+        m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
+        return QVector<ProductEntity>();
+    }
+    return materialize<ProductEntity>(q, productFromRow);
+}
+
+QVector<ActivityEntity> DatabaseModule::loadActivities(const QString &condition, const QVariantList &binds, Page page)
+{
+    QSqlQuery q = cachedQuery("SELECT " + ACTIVITY_COLUMNS + " FROM Activities" + pagedWhere(condition, "id"));
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    q.addBindValue(page.afterId);
+    q.addBindValue(page.limit);
+    if(!q.exec()){
+        m_errorList << "Error:" << Q_FUNC_INFO << "Wrong condition" << q.lastError().text();
+        return QVector<ActivityEntity>();
+    }
+    return materialize<ActivityEntity>(q, activityFromRow);
+}
+
+const ProductCatalog &DatabaseModule::loadedProductCatalog(ProductCatalog &snapshot)
+{
+    ProductCatalog& catalog = sharedProductCatalog();
+    if (catalog.isLoaded()) {
+        return catalog;
+    }
+    const quint64 generation = catalog.generation();
+    auto prevErrorSize = m_errorList.size();
+    auto allProducts = loadProducts(QString(), QVariantList(), Page());
+    if (m_errorList.size() == prevErrorSize && catalog.load(allProducts, generation)) {
+        return catalog;
+    }
+    /// Failed or changed while loading: the snapshot answers once, the next call loads again
+    snapshot.load(allProducts, snapshot.generation());
+    return snapshot;
+}
+
+const RecipeCatalog &DatabaseModule::loadedRecipeCatalog(RecipeCatalog &snapshot) const
+{
+    RecipeCatalog& catalog = sharedRecipeCatalog();
+    if (catalog.isLoaded()) {
+        return catalog;
+    }
+    const quint64 generation = catalog.generation();
+    bool isOk = false;
+    auto allRecipes = loadRecipeSummaries(QString(), QVariantList(), Page(), &isOk);
+    /// An empty list of a successful query is kept too, so a database without recipes is read once
+    if (isOk && catalog.load(allRecipes, generation)) {
+        return catalog;
+    }
+    /// Failed or changed while loading: the snapshot answers once, the next call loads again
+    snapshot.load(allRecipes, snapshot.generation());
+    return snapshot;
+}
+
+QString DatabaseModule::notUpdatedReason(const QString &table, int id, int version) const
+{
+    /// Only on the failure path: a saved edit costs the UPDATE alone
+    QSqlQuery q = cachedQuery("SELECT version FROM " + table + " WHERE id = ?");
+    q.addBindValue(id);
+    if (!q.exec()) {
+        return q.lastError().text();
+    }
+    if (!q.next()) {
+        return QString("In DB has no row of %1 with id: %2").arg(table).arg(id);
+    }
+    return QString("Row %1 of %2 was changed by another window: version %3, the edit was read at %4")
+            .arg(id).arg(table).arg(q.value(0).toInt()).arg(version);
+}
+
+QString DatabaseModule::recipeSearchCondition(const QStringList &seachLine, QVariantList &binds) const
+{
+    QStringList words = seachLine.filter(QRegExp("\\S"));
+    if (words.isEmpty()) {
+        return QString();
+    }
+
+    if (m_isFullTextSearch) {
+        binds << ftsPrefixQuery(words);
+        return "id IN (SELECT rowid FROM RecipesFts WHERE RecipesFts MATCH ?)";
+    }
+    words = paddedWords(words);
+    foreach (const QString& word, words) {
+        binds << "%" + word + "%";
+    }
+    return likeCondition({"name"}, words.size());
+}
+
+QString DatabaseModule::recipeIntervalCondition(QPair<float, float> interval, const char type, QVariantList &binds) const
+{
+    QString stype;
+    switch (type) {
+    case 'c': { stype = "carbohydrates"; } break;
+    case 'f': { stype = "fats"; } break;
+    case 'p': { stype = "proteins"; } break;
+    case 'k': { stype = "kcal"; } break;
+    default: {
+        stype = "";
+    }
+    }
+    if (stype.isEmpty()) {
+        return QString();
+    }
+    /// Indexed, the totals are maintained by the triggers of the schema version 6
+    binds << interval.first << interval.second;
+    return stype + " BETWEEN ? AND ?";
+}
+
+QString DatabaseModule::clientSearchCondition(const QString &snp, QVariantList &binds) const
+{
+    QStringList snpList = snp.toLower().split(QRegExp("[\\s,.]+"), QString::SkipEmptyParts);
+    if (snpList.isEmpty()) {
+        return QString();
+    }
+
+    if (m_isFullTextSearch) {
+        binds << ftsPrefixQuery(snpList);
+        return "id IN (SELECT rowid FROM ClientsFts WHERE ClientsFts MATCH ?)";
+    }
+    snpList = paddedWords(snpList);
+    foreach (QString snp, snpList) {
+        snp[0] = snp[0].toUpper();
+        binds << snp + "%" << snp + "%" << snp + "%";
+    }
+    return likeCondition({"surname", "name", "patronymic"}, snpList.size());
+}
+
+QVector<RecipeSummary> DatabaseModule::loadRecipeSummaries(const QString &condition, const QVariantList &binds, Page page,
+                                                           bool *isOk) const
+{
+    QSqlQuery q = cachedQuery("SELECT id, name, proteins, fats, carbohydrates, kcal, weight FROM Recipes" + pagedWhere(condition, "id"));
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    q.addBindValue(page.afterId);
+    q.addBindValue(page.limit);
+    if(!q.exec()){
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        if (isOk) {
+            *isOk = false;
         }
+        return QVector<RecipeSummary>();
+    }
+
+    if (isOk) {
+        *isOk = true;
     }
+    return materialize<RecipeSummary>(q, [](const QSqlQuery& row) {
+        return RecipeSummary{ row.value(0).toInt(), row.value(1).toString(), row.value(2).toFloat(),
+                              row.value(3).toFloat(), row.value(4).toFloat(), row.value(5).toFloat(),
+                              row.value(6).toFloat() };
+    });
 }
 
-bool DatabaseModule::insertIntoCookingPoints(unsigned recipeID, const QStringList &cookingP)
+QVector<ExaminationSummary> DatabaseModule::loadExaminationSummaries(const QString &condition, const QVariantList &binds, Page page) const
 {
-    for (auto i = 0; i < cookingP.size(); ++i) {
-        auto pointDescription = cookingP.at(i);
-        QSqlQuery q2;
-        q2.prepare("INSERT INTO CookingPoints (recipe_id, point_num, description)"
-                  "VALUES( ?, ?, ? );");
-        q2.addBindValue(recipeID);
-        q2.addBindValue(i);
-        q2.addBindValue(pointDescription);
+    QSqlQuery q = cachedQuery("SELECT e.id, e.is_full_examination, e.date, c.id, c.surname, c.name, c.patronymic"
+                              " FROM Examinations e JOIN Clients c ON c.id = e.client_id" + pagedWhere(condition, "e.id"));
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    q.addBindValue(page.afterId);
+    q.addBindValue(page.limit);
+    if(!q.exec()){
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        return QVector<ExaminationSummary>();
+    }
 
-        if(!q2.exec()) {
-            m_errorList << "Error: in " << Q_FUNC_INFO << "!q2!" << q2.lastError().text();
+    return materialize<ExaminationSummary>(q, [](const QSqlQuery& row) {
+        ClientSummary client{ row.value(3).toInt(), row.value(4).toString(),
+                              row.value(5).toString(), row.value(6).toString() };
+        return ExaminationSummary{ row.value(0).toInt(), client, row.value(1).toBool(),
+                                   QDateTime::fromString(row.value(2).toString(), Qt::ISODate) };
+    });
+}
+
+QVector<RecipeEntity> DatabaseModule::hydrateRecipes(const QString &condition, const QVariantList &binds)
+{
+    const QString where = condition.isEmpty() ? QString() : " WHERE " + condition;
+    const QString recipeIds = "SELECT id FROM Recipes" + where;
+
+    auto exec = [this, &binds](QSqlQuery& q, const QString& sql){
+        q = cachedQuery(sql);
+        for (const QVariant& value : binds) {
+            q.addBindValue(value);
+        }
+        if (!q.exec()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
             return false;
         }
+        return true;
+    };
+
+    ///
+    /// Рецепты
+    ///
+    QSqlQuery recipesQ;
+    if (!exec(recipesQ, "SELECT id, name, version FROM Recipes" + where + " ORDER BY id")) {
+        return QVector<RecipeEntity>();
+    }
+    QVector<int> ids;
+    QStringList names;
+    QVector<int> versions;
+    QHash<int, int> indexById;
+    while (recipesQ.next()) {
+        indexById.insert(recipesQ.value(0).toInt(), ids.size());
+        ids << recipesQ.value(0).toInt();
+        names << recipesQ.value(1).toString();
+        versions << recipesQ.value(2).toInt();
+    }
+    if (ids.isEmpty()) {
+        return QVector<RecipeEntity>();
+    }
+    QVector<QVector<WeightedProduct>> products(ids.size());
+    QVector<QStringList> cookingPoints(ids.size());
+
+    ///
+    /// Продукты всех рецептов, каждый продукт создается один раз
+    ///
+    QSqlQuery productsQ;
+    if (!exec(productsQ, "SELECT pr.recipe_id, pr.amound, " + qualifiedColumns(PRODUCT_COLUMNS, "p") +
+                         " FROM ProductsInRecipes pr INNER JOIN Products p ON p.id = pr.product_id"
+                         " WHERE pr.recipe_id IN (" + recipeIds + ")"
+                         " ORDER BY pr.recipe_id, pr.rowid")) {
+        return QVector<RecipeEntity>();
+    }
+    QHash<int, ProductEntity> productsById;
+    while (productsQ.next()) {
+        int productId = productsQ.value(2 + ProductId).toInt();
+        auto product = productsById.find(productId);
+        if (product == productsById.end()) {
+            product = productsById.insert(productId, productFromColumns(productsQ, 2));
+        }
+        int index = indexById.value(productsQ.value(0).toInt());
+        products[index].push_back(WeightedProduct(*product, productsQ.value(1).toFloat()));
     }
-    return true;
+
+    ///
+    /// Пункты приготовления
+    ///
+    QSqlQuery pointsQ;
+    if (!exec(pointsQ, "SELECT recipe_id, description FROM CookingPoints"
+                       " WHERE recipe_id IN (" + recipeIds + ")"
+                       " ORDER BY recipe_id, point_num")) {
+        return QVector<RecipeEntity>();
+    }
+    while (pointsQ.next()) {
+        int index = indexById.value(pointsQ.value(0).toInt());
+        cookingPoints[index] << pointsQ.value(1).toString();
+    }
+
+    QVector<RecipeEntity> recipes;
+    recipes.reserve(ids.size());
+    for (int i = 0; i < ids.size(); ++i) {
+        recipes.push_back(RecipeEntity(ids[i], names[i], products[i], cookingPoints[i]));
+        recipes.back().setVersion(versions[i]);
+    }
+    return recipes;
+}
+
+QVector<Examination> DatabaseModule::materializeExaminations(QSqlQuery &q, const Client &client) const
+{
+    /// Identity map for this result set: every visit of a client shares one Client
+    QHash<int, Client> owners;
+    if (client.isInit()) {
+        owners.insert(client.id(), client);
+    }
+
+    QVector<Examination> examinations;
+    while(q.next()) {
+        int clientId = q.value(ExaminationClientId).toInt();
+        auto owner = owners.constFind(clientId);
+        if (owner == owners.constEnd()) {
+            owner = owners.insert(clientId, clientFromColumns(q, ExaminationFirstClientColumn));
+        }
+        Examination exm;
+        exm.setClient(owner.value());
+        examinationFromRow(q, exm);
+        examinations.push_back(exm);
+    }
+    return examinations;
+}
+
+QVector<Examination> DatabaseModule::loadExaminations(const QString &condition, const QVariantList &binds,
+                                                      const Client &client, ExaminationProjection projection) const
+{
+    const QString where = condition.isEmpty() ? "" : " WHERE " + condition;
+
+    QSqlQuery q = cachedQuery("SELECT " + qualifiedColumns(EXAMINATION_COLUMNS, "e") + ", " + qualifiedColumns(CLIENT_COLUMNS, "c")
+                              + " FROM Examinations e JOIN Clients c ON c.id = e.client_id" + where + " ORDER BY e.id");
+    for (const QVariant& bind : binds) {
+        q.addBindValue(bind);
+    }
+    if(!q.exec()) {
+        qDebug() << "Error:" << Q_FUNC_INFO << q.lastError().text();
+        return QVector<Examination>();
+    }
+    QVector<Examination> examinations = materializeExaminations(q, client);
+    if (projection == ExaminationListView || examinations.isEmpty()) {
+        return examinations;
+    }
+
+    QHash<int, int> indexById;
+    for (int i = 0; i < examinations.size(); ++i) {
+        indexById.insert(examinations[i].id(), i);
+    }
+
+    QSqlQuery values = cachedQuery("SELECT " + EXAMINATION_VALUE_COLUMNS + " FROM ExaminationValues"
+                                   " WHERE examination_id IN (SELECT e.id FROM Examinations e" + where + ")"
+                                   + (projection == ExaminationReportView ? " AND field IN (" + REPORT_FIELDS + ")" : "")
+                                   + " ORDER BY examination_id, field");
+    for (const QVariant& bind : binds) {
+        values.addBindValue(bind);
+    }
+    if(!values.exec()) {
+        qDebug() << "Error:" << Q_FUNC_INFO << values.lastError().text();
+        return QVector<Examination>();
+    }
+    while (values.next()) {
+        auto index = indexById.constFind(values.value(ValueExaminationId).toInt());
+        if (index == indexById.constEnd()) {
+            continue;
+        }
+        examinations[index.value()].setFieldValue(values.value(ValueField).toInt(), fieldValueFromRow(values));
+    }
+    return examinations;
+}
+
+bool DatabaseModule::insertIntoExaminationValues(int examinationId, const QVector<FormField> &fields)
+{
+    /// Empty fields are not stored
+    QVector<FormField> filled;
+    for (const FormField& field : fields) {
+        if (!field.value().isEmpty()) {
+            filled << field;
+        }
+    }
+
+    return insertRows("INSERT INTO ExaminationValues (" + EXAMINATION_VALUE_COLUMNS + ")", 5,
+                      filled.size(), [&](QSqlQuery& q, int i) {
+        q.addBindValue(examinationId);
+        q.addBindValue(Examination::fieldNumber(filled[i].name()));
+        bindFieldValue(q, filled[i]);
+    });
+}
+
+bool DatabaseModule::insertIntoCookingPoints(unsigned recipeID, const QStringList &cookingP, int firstPointNum)
+{
+    return insertRows("INSERT INTO CookingPoints (recipe_id, point_num, description)", 3,
+                      cookingP.size(), [&](QSqlQuery& q, int i) {
+        q.addBindValue(recipeID);
+        q.addBindValue(firstPointNum + i);
+        q.addBindValue(cookingP.at(i));
+    });
 }
 
 bool DatabaseModule::insertIntoProductsInRecipes(unsigned recipeId, const QVector<WeightedProduct> &products)
 {
-    for(const auto& product : products){
-        QSqlQuery q3;
-        q3.prepare("INSERT INTO ProductsInRecipes (recipe_id, product_id, amound)"
-                   "VALUES( ?, ?, ? );");
-        q3.addBindValue(recipeId);
-        q3.addBindValue(product.product().id());
-        q3.addBindValue(product.amound());
-        if(!q3.exec()) {
-            m_errorList << "Error: in " << Q_FUNC_INFO << "!q3!" << q3.lastError().text();
+    return insertRows("INSERT INTO ProductsInRecipes (recipe_id, product_id, amound)", 3,
+                      products.size(), [&](QSqlQuery& q, int i) {
+        q.addBindValue(recipeId);
+        q.addBindValue(products.at(i).product().id());
+        q.addBindValue(products.at(i).amound());
+    });
+}
+
+bool DatabaseModule::updateProductsInRecipes(unsigned recipeId, const QVector<WeightedProduct> &products)
+{
+    /// The ingredients are ordered by rowid, the stored rows are rewritten in place
+    QSqlQuery stored = cachedQuery("SELECT rowid, product_id, amound FROM ProductsInRecipes"
+                                   " WHERE recipe_id = ? ORDER BY rowid");
+    stored.addBindValue(recipeId);
+    if (!stored.exec()) {
+        m_errorList << "Error: in " << Q_FUNC_INFO << stored.lastError().text();
+        return false;
+    }
+    /// amound is REAL, it is compared as stored, a truncated fractional amount would never match
+    struct StoredIngredient {
+        int     productId;
+        double  amound;
+    };
+    QVector<qlonglong> rowIds;
+    QVector<StoredIngredient> oldProducts;
+    while (stored.next()) {
+        rowIds << stored.value(0).toLongLong();
+        oldProducts << StoredIngredient{ stored.value(1).toInt(), stored.value(2).toDouble() };
+    }
+    stored.finish();
+
+    auto isSame = [](const StoredIngredient& a, const WeightedProduct& b) {
+        return a.productId == b.product().id() && a.amound == double(b.amound());
+    };
+    const int oldCount = oldProducts.size();
+    const int newCount = products.size();
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && isSame(oldProducts[prefix], products[prefix])) {
+        ++prefix;
+    }
+    /// A common tail is kept only if rows are removed before it: new rows can only be appended
+    int suffix = 0;
+    if (newCount <= oldCount) {
+        while (suffix < newCount - prefix
+               && isSame(oldProducts[oldCount - 1 - suffix], products[newCount - 1 - suffix])) {
+            ++suffix;
+        }
+    }
+    const int oldEnd = oldCount - suffix;
+    const int newEnd = newCount - suffix;
+
+    int i = prefix;
+    for (; i < oldEnd && i < newEnd; ++i) {
+        if (isSame(oldProducts[i], products[i])) {
+            continue;
+        }
+        QSqlQuery q = cachedQuery("UPDATE ProductsInRecipes SET product_id = ?, amound = ? WHERE rowid = ?");
+        q.addBindValue(products[i].product().id());
+        q.addBindValue(products[i].amound());
+        q.addBindValue(rowIds[i]);
+        if (!q.exec()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+            return false;
+        }
+    }
+    for (int removed = i; removed < oldEnd; ++removed) {
+        QSqlQuery q = cachedQuery("DELETE FROM ProductsInRecipes WHERE rowid = ?");
+        q.addBindValue(rowIds[removed]);
+        if (!q.exec()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+            return false;
+        }
+    }
+    return i >= newEnd || insertIntoProductsInRecipes(recipeId, products.mid(i, newEnd - i));
+}
+
+bool DatabaseModule::updateCookingPoints(unsigned recipeId, const QStringList &cookingP)
+{
+    QSqlQuery stored = cachedQuery("SELECT point_num, description FROM CookingPoints"
+                                   " WHERE recipe_id = ? ORDER BY point_num");
+    stored.addBindValue(recipeId);
+    if (!stored.exec()) {
+        m_errorList << "Error: in " << Q_FUNC_INFO << stored.lastError().text();
+        return false;
+    }
+    QStringList oldPoints;
+    bool isNumbered = true;             // point_num is 0, 1, 2...
+    while (stored.next()) {
+        isNumbered = isNumbered && stored.value(0).toInt() == oldPoints.size();
+        oldPoints << stored.value(1).toString();
+    }
+    stored.finish();
+
+    auto exec = [this](QSqlQuery& q) {
+        if (!q.exec()) {
+            m_errorList << "Error: in " << Q_FUNC_INFO << q.lastError().text();
+            return false;
+        }
+        return true;
+    };
+
+    /// Points of an older database may have gaps, they are written again numbered
+    if (!isNumbered) {
+        QSqlQuery q = cachedQuery("DELETE FROM CookingPoints WHERE recipe_id = ?");
+        q.addBindValue(recipeId);
+        return exec(q) && insertIntoCookingPoints(recipeId, cookingP);
+    }
+
+    const int oldCount = oldPoints.size();
+    const int newCount = cookingP.size();
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && oldPoints[prefix] == cookingP[prefix]) {
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+           && oldPoints[oldCount - 1 - suffix] == cookingP[newCount - 1 - suffix]) {
+        ++suffix;
+    }
+    const int oldEnd = oldCount - suffix;
+    const int newEnd = newCount - suffix;
+
+    /// Changed points in place
+    int i = prefix;
+    for (; i < oldEnd && i < newEnd; ++i) {
+        if (oldPoints[i] == cookingP[i]) {
+            continue;
+        }
+        QSqlQuery q = cachedQuery("UPDATE CookingPoints SET description = ? WHERE recipe_id = ? AND point_num = ?");
+        q.addBindValue(cookingP[i]);
+        q.addBindValue(recipeId);
+        q.addBindValue(i);
+        if (!exec(q)) {
+            return false;
+        }
+    }
+
+    /// Removed points, the tail moves up
+    if (i < oldEnd) {
+        QSqlQuery q = cachedQuery("DELETE FROM CookingPoints WHERE recipe_id = ? AND point_num >= ? AND point_num < ?");
+        q.addBindValue(recipeId);
+        q.addBindValue(i);
+        q.addBindValue(oldEnd);
+        if (!exec(q)) {
+            return false;
+        }
+    }
+    /// or added points, the tail moves down to make room
+    if (oldEnd != newEnd && suffix > 0) {
+        QSqlQuery q = cachedQuery("UPDATE CookingPoints SET point_num = point_num + ? WHERE recipe_id = ? AND point_num >= ?");
+        q.addBindValue(newEnd - oldEnd);
+        q.addBindValue(recipeId);
+        q.addBindValue(oldEnd);
+        if (!exec(q)) {
             return false;
         }
     }
+    return i >= newEnd || insertIntoCookingPoints(recipeId, cookingP.mid(i, newEnd - i), i);
+}
+
+bool DatabaseModule::beginTransaction()
+{
+    if (m_transactionDepth++ > 0) {
+        return true;
+    }
+    m_isTransactionFailed = false;
+    if (!_db.transaction()) {
+        m_errorList << "Error: in " << Q_FUNC_INFO << _db.lastError().text();
+        m_transactionDepth = 0;
+        return false;
+    }
     return true;
 }
+
+bool DatabaseModule::endTransaction(bool isOk)
+{
+    if (!isOk) {
+        m_isTransactionFailed = true;
+    }
+    if (--m_transactionDepth > 0) {
+        return isOk;
+    }
+    if (!m_isTransactionFailed && _db.commit()) {
+        return true;
+    }
+    if (!m_isTransactionFailed) {
+        m_errorList << "Error: in " << Q_FUNC_INFO << _db.lastError().text();
+    }
+    _db.rollback();
+    return false;
+}
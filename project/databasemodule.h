@@ -2,45 +2,91 @@
 #include <QVector>
 #include <QString>
 #include <QDate>
+#include <QVariant>
+#include <QHash>
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
 
 #include "entities/client.h"
 #include "entities/examination.h"
 #include "entities/product.h"
 #include "entities/recipe.h"
 #include "entities/activity.h"
+#include "entities/summaries.h"
+#include "productcatalog.h"
+#include "recipecatalog.h"
+#include "entitycache.h"
+#include "examinationtrends.h"
 
 class DatabaseModule
 {
 public:
-    DatabaseModule();
+    enum ConnectionMode {
+        ReadWrite,                  // creates and migrates the database file
+        ReadOnly                    // a reader of the pool, the schema is expected to be up to date
+    };
+
+    explicit DatabaseModule(const QString& connectionName = QLatin1String(QSqlDatabase::defaultConnection),
+                            ConnectionMode mode = ReadWrite);
+    ~DatabaseModule();
+
+    struct StatementCacheStats {
+        int hits = 0;
+        int misses = 0;
+        int size = 0;
+    };
+
+    /// Keyset page of a list: rows with id > afterId in the id order, limit < 0 - all of them
+    struct Page {
+        int afterId = 0;
+        int limit = -1;
+    };
+
+    /// Which part of an examination is loaded
+    enum ExaminationProjection {
+        ExaminationListView,        // id, client, type and date, for the lists
+        ExaminationReportView,      // + the fields of the consultation report
+        ExaminationFullView         // + all the form fields
+    };
 
     /* functions to work with Product entities */
     unsigned                addProduct(const ProductEntity& );
-    void                    deleteProduct(const ProductEntity& );
+    QVector<unsigned>       addProducts(const QVector<ProductEntity>& );         // one transaction, empty on failure
+    void                    deleteProduct(const ProductEntity& );               // refused while a recipe uses it
+    int                     recipesWithProduct(const ProductEntity& ) const;    // -1 on error
     ProductEntity           product(unsigned id);
-    QVector<ProductEntity>  products();
-    QVector<ProductEntity>  products(const QStringList &seachLine);
-    QVector<ProductEntity>  products(QPair<float,float> interval, const char type); /// type: {c, f, p, k}
-    void                    changeProductInformation(const ProductEntity& );
+    QVector<ProductEntity>  products(Page page = Page());
+    QVector<ProductEntity>  products(const QStringList &seachLine, Page page = Page());
+    QVector<ProductEntity>  products(QPair<float,float> interval, const char type, Page page = Page()); /// type: {c, f, p, k}
+    QVector<ProductEntity>  products(const ProductCatalog::Filter& filter, Page page = Page());      // in memory, see ProductCatalog
+    QVector<ProductEntity>  searchProducts(const QString& text, int limit = -1);        // ranked, in memory, see SearchIndex
+    void                    changeProductInformation(ProductEntity& );           // saves over the read version, then increments it
 
     /* functions to work with Recipe entities */
     unsigned                addRecipe(const RecipeEntity& );
+    QVector<unsigned>       addRecipes(const QVector<RecipeEntity>& );           // one transaction, empty on failure
     void                    deleteRecipe(const RecipeEntity& );
     RecipeEntity            recipe(unsigned id);
     QVector<RecipeEntity>   recipes();
+    QVector<RecipeEntity>   recipes(const QVector<unsigned> &ids);
     QVector<RecipeEntity>   recipes(const QStringList &seachLine);
-    QVector<RecipeEntity>   recipes(QPair<float,float> interval, const char type); /*<- NOT IMPLEMENTED*/  /// type: {c, f, p, k}
-    void                    changeRecipeInformation(const RecipeEntity& );
+    QVector<RecipeEntity>   recipes(QPair<float,float> interval, const char type); /// type: {c, f, p, k}
+    QVector<RecipeSummary>  recipeSummaries(Page page = Page()) const;
+    QVector<RecipeSummary>  recipeSummaries(const QStringList &seachLine, Page page = Page()) const;
+    QVector<RecipeSummary>  recipeSummaries(QPair<float,float> interval, const char type, Page page = Page()) const;
+    QVector<RecipeSummary>  recipeSummaries(const RecipeCatalog::Filter& filter, Page page = Page()) const;   // in memory, see RecipeCatalog
+    QVector<RecipeSummary>  searchRecipes(const QString& text, int limit = -1) const;   // ranked, in memory, see SearchIndex
+    void                    changeRecipeInformation(RecipeEntity& );             // one commit, the same check
 
     /* functions to work with Activity entities */
     unsigned                addActivity(const ActivityEntity& );
+    QVector<unsigned>       addActivities(const QVector<ActivityEntity>& );      // one transaction, empty on failure
     void                    deleteActivity(const ActivityEntity& );
     ActivityEntity          activity(unsigned id);
-    QVector<ActivityEntity> activities();
-    QVector<ActivityEntity> activities(const QStringList &seachLine);
-    QVector<ActivityEntity> activities(QPair<float,float> kkmInterval);                              // kkm - kkal/kg/min
-    void                    changeActivityInformation(const ActivityEntity& );
+    QVector<ActivityEntity> activities(Page page = Page());
+    QVector<ActivityEntity> activities(const QStringList &seachLine, Page page = Page());
+    QVector<ActivityEntity> activities(QPair<float,float> kkmInterval, Page page = Page());         // kkm - kkal/kg/min
+    void                    changeActivityInformation(ActivityEntity& );
 
     /* functions to work with Client entities */
     bool                    addClientAndSetID(Client & );                       //TODO: Need to be change as in the previous style
@@ -48,15 +94,22 @@ public:
     Client                  client(int id, bool &isOk) const;
     QVector<Client>         clients(const QString& snp) const;
     QVector<Client>         clients() const;
-    bool                    changeClientInformation(const Client& );
+    QVector<ClientSummary>  clientSummaries(Page page = Page()) const;
+    QVector<ClientSummary>  clientSummaries(const QString& snp, Page page = Page()) const;
+    bool                    changeClientInformation(Client& );                  // false if not found or saved by another window
 
     /* functions to work with Examination entities */
     bool                    addExaminationAndSetID(Examination& );      //TODO: Need to be change as in the previous style
     void                    deleteExamination(const Examination& );
-    Examination             examination(int id, bool &isOk, Client client = Client()) const;
-    QVector<Examination>    examinations(Client client = Client()) const;
-    QVector<Examination>    examinations(QDate from, QDate to) const;
-    bool                    changeExaminationInformation(Examination & ); //without id, client_id, is_full_examination, date
+    Examination             examination(int id, bool &isOk, Client client = Client(),
+                                        ExaminationProjection projection = ExaminationFullView) const;
+    QVector<Examination>    examinations(Client client = Client(), ExaminationProjection projection = ExaminationFullView) const;
+    QVector<Examination>    examinations(QDate from, QDate to, ExaminationProjection projection = ExaminationFullView) const;
+    QVector<ExaminationSummary> examinationSummaries(Page page = Page()) const;
+    QVector<ExaminationSummary> examinationSummaries(const QString& snp, Page page = Page()) const;     // by the client name
+    QVector<ExaminationSummary> examinationSummaries(QDate from, QDate to, Page page = Page()) const;
+    bool                    changeExaminationInformation(Examination & ); //without id, client_id, is_full_examination, date; over the read version
+    ExaminationTrends       examinationTrends(const Client& client) const;
 
     /* Specific database functions */
     bool importDB(const QString& fileName);
@@ -65,15 +118,64 @@ public:
     bool hasUnwatchedWorkError();           //Lets you know if there was an Unwatched Error at DataBase job time
     QStringList unwatchedWorkError();
 
+    StatementCacheStats statementCacheStats() const;    //Diagnostics of the prepared statements reuse
+    EntityCache::Stats entityCacheStats() const;        //Diagnostics of the entities read by id
+    QStringList connectionProfile() const;              //SQLite pragmas in effect, "name=value"
+
 private:
     QSqlDatabase    _db;
     const QString   _DB_TYPE = "QSQLITE";
     //const QString   _DB_NAME = "../project/database/db.sqlite";  //INFO : For DEBUG :TODO :WARNING
     const QString   _DB_NAME = "./database/db.sqlite";
     //const QString   _DB_NAME = "/Users/ilkin_galoev/Documents/7 semester/Fundamentals of Software Engineering/nutritionist-helper/project/database/db.sqlite";
+    const QString   _DB_CONFIG_NAME = "./database/db.ini";          //[sqlite] journal_mode, synchronous, temp_store, mmap_size, cache_size, foreign_keys; [cache] entity_budget
     QStringList     m_errorList;
+    QStringList     m_connectionProfile;
+    bool            m_isFullTextSearch = false;     // FTS5 tables exist, otherwise the searches use LIKE
+
+    /// Compiled statements keyed by their SQL text. A statement requested again while
+    /// a previous result of it is still being read is prepared anew and not cached.
+    static constexpr int STATEMENT_CACHE_CAPACITY = 128;
+    mutable QHash<QString, QSqlQuery>   m_statements;
+    mutable int                         m_statementCacheHits = 0;
+    mutable int                         m_statementCacheMisses = 0;
+    static constexpr int IDS_PER_QUERY = 100;       // "id IN (?, ...)" of a fixed size, one cached statement for any id list
+    static constexpr int ROWS_PER_INSERT = 100;     // keeps multi-row INSERTs below the SQLite bind limit
+
+    /// Nested transactions are joined into the outermost one
+    int             m_transactionDepth = 0;
+    bool            m_isTransactionFailed = false;
 
     void initEmptyDB();
-    bool insertIntoCookingPoints(unsigned recipeId, const QStringList& );
+    void applyConnectionProfile();
+    void upgradeSchema();                       // applies the pending schema migrations
+    void detectFullTextSearch();
+    QSqlQuery cachedQuery(const QString& sql) const;
+    void evictStatements() const;               // the ones nobody reads
+    void clearStatementCache() const;
+    QString recipeSearchCondition(const QStringList& seachLine, QVariantList& binds) const;
+    QString recipeIntervalCondition(QPair<float,float> interval, const char type, QVariantList& binds) const;
+    QString clientSearchCondition(const QString& snp, QVariantList& binds) const;
+    QString notUpdatedReason(const QString& table, int id, int version) const;   // why an UPDATE of a version matched no row
+    const ProductCatalog& loadedProductCatalog(ProductCatalog& snapshot);      // the shared one or the loaded snapshot
+    const RecipeCatalog& loadedRecipeCatalog(RecipeCatalog& snapshot) const;
+    QVector<ProductEntity> loadProducts(const QString& condition, const QVariantList& binds, Page page);
+    QVector<ActivityEntity> loadActivities(const QString& condition, const QVariantList& binds, Page page);
+    QVector<RecipeSummary> loadRecipeSummaries(const QString& condition, const QVariantList& binds, Page page,
+                                               bool* isOk = nullptr) const;    // isOk is false if the query failed
+    QVector<ExaminationSummary> loadExaminationSummaries(const QString& condition, const QVariantList& binds, Page page) const;
+    QVector<RecipeEntity> hydrateRecipes(const QString& recipesCondition, const QVariantList& binds);   // 3 queries for any number of recipes
+    QVector<Examination> materializeExaminations(QSqlQuery& , const Client& client = Client()) const;    // rows joined with Clients
+    QVector<Examination> loadExaminations(const QString& condition, const QVariantList& binds,
+                                          const Client& client, ExaminationProjection projection) const;   // 2 queries: rows and field values
+    template<typename BindRow>
+    bool insertRows(const QString& insert, int columns, int count, BindRow bindRow,
+                    QVector<unsigned>* ids = nullptr);  // multi-row INSERTs of ROWS_PER_INSERT rows at most, bindRow(q, row)
+    bool insertIntoExaminationValues(int examinationId, const QVector<FormField>& );
+    bool insertIntoCookingPoints(unsigned recipeId, const QStringList& , int firstPointNum = 0);
     bool insertIntoProductsInRecipes(unsigned recipeId, const QVector<WeightedProduct>& );
+    bool updateProductsInRecipes(unsigned recipeId, const QVector<WeightedProduct>& );     // writes only the differences
+    bool updateCookingPoints(unsigned recipeId, const QStringList& );                    // to the stored rows
+    bool beginTransaction();
+    bool endTransaction(bool isOk);             // commits the outermost transaction or rolls it back
 };
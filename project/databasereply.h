@@ -0,0 +1,9 @@
+#pragma once
+#include <QStringList>
+
+/// The result of a request run on a reader connection, with the errors of that request only
+template<typename T>
+struct DatabaseReply {
+    T           result;
+    QStringList errors;
+};
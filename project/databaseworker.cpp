@@ -0,0 +1,40 @@
+#include "databaseworker.h"
+
+#include <QThread>
+
+DatabaseWorker::DatabaseWorker()
+    : m_isOpen(1)
+{
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), MAX_READERS));
+    m_pool.setExpiryTimeout(-1);        // an idle thread keeps its connection
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    closeConnection();
+}
+
+void DatabaseWorker::closeConnection()
+{
+    /// The queued requests are skipped, the threads exit with their connections
+    m_isOpen.storeRelease(0);
+    m_pool.waitForDone();
+}
+
+void DatabaseWorker::openConnection()
+{
+    m_isOpen.storeRelease(1);
+}
+
+DatabaseModule* DatabaseWorker::reader()
+{
+    if (!m_isOpen.loadAcquire()) {
+        return nullptr;
+    }
+    if (!m_readers.hasLocalData()) {
+        auto db = new DatabaseModule(QString("reader-%1").arg(m_readerCount.fetchAndAddRelaxed(1)),
+                                     DatabaseModule::ReadOnly);
+        m_readers.setLocalData(db);
+    }
+    return m_readers.localData();
+}
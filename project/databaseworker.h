@@ -0,0 +1,101 @@
+#pragma once
+#include <QObject>
+#include <QThreadPool>
+#include <QThreadStorage>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <functional>
+
+#include "databasemodule.h"
+#include "databasereply.h"
+
+/// Runs DatabaseModule reads on a pool of threads, so the GUI thread never waits
+/// for SQL and independent loads run in parallel. Every pool thread owns its own
+/// read-only connection (WAL lets readers work beside the writer). The writes stay
+/// on the single read-write connection of the GUI thread, so they are serialized.
+class DatabaseWorker
+{
+public:
+    DatabaseWorker();
+    ~DatabaseWorker();                  // finishes the queued requests and closes the connections
+
+    /// Queues job(DatabaseModule&) on a reader thread. A request cancelled
+    /// before it starts is skipped, the result of a cancelled running one is dropped.
+    /// The errors of the request come with its result, the readers keep none between requests.
+    template<typename T, typename Job>
+    QFuture<DatabaseReply<T>> run(Job job);
+
+    /// The same, done(T, QStringList errors) is called on the thread of context unless context is destroyed first
+    template<typename T, typename Job, typename Done>
+    void run(QObject* context, Job job, Done done);
+
+    /// Source of a paged list: fetch(DatabaseModule&, DatabaseModule::Page) is queued for every page
+    template<typename Row, typename Fetch>
+    std::function<QFuture<DatabaseReply<QVector<Row>>>(int, int)> pagedSource(Fetch fetch);
+
+    void closeConnection();             // blocks until the readers release the database file
+    void openConnection();
+
+private:
+    class Task : public QRunnable
+    {
+    public:
+        explicit Task(std::function<void()> job) : m_job(job) {}
+        void run() override { m_job(); }
+    private:
+        std::function<void()> m_job;
+    };
+
+    static constexpr int MAX_READERS = 4;
+
+    QThreadStorage<DatabaseModule*> m_readers;      // deleted with their threads
+    QThreadPool     m_pool;                         // declared after m_readers, its threads finish first
+    QAtomicInt      m_isOpen;
+    QAtomicInt      m_readerCount;                  // names the reader connections
+
+    DatabaseModule* reader();                       // the connection of the current pool thread
+};
+
+template<typename T, typename Job>
+QFuture<DatabaseReply<T>> DatabaseWorker::run(Job job)
+{
+    QFutureInterface<DatabaseReply<T>> promise;
+    promise.reportStarted();
+    m_pool.start(new Task([this, promise, job]() mutable {
+        DatabaseModule* db = promise.isCanceled() ? nullptr : reader();
+        if (db) {
+            DatabaseReply<T> reply;
+            reply.result = job(*db);
+            reply.errors = db->unwatchedWorkError();    // with the errors of opening a new connection
+            promise.reportResult(reply);
+        }
+        promise.reportFinished();
+    }));
+    return promise.future();
+}
+
+template<typename T, typename Job, typename Done>
+void DatabaseWorker::run(QObject* context, Job job, Done done)
+{
+    auto watcher = new QFutureWatcher<DatabaseReply<T>>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, context, [watcher, done]() {
+        watcher->deleteLater();
+        const DatabaseReply<T> reply = watcher->future().resultCount() > 0 ? watcher->result() : DatabaseReply<T>();
+        done(reply.result, reply.errors);
+    });
+    watcher->setFuture(run<T>(job));
+}
+
+template<typename Row, typename Fetch>
+std::function<QFuture<DatabaseReply<QVector<Row>>>(int, int)> DatabaseWorker::pagedSource(Fetch fetch)
+{
+    return [this, fetch](int afterId, int limit) {
+        return run<QVector<Row>>([fetch, afterId, limit](DatabaseModule& db) {
+            return fetch(db, DatabaseModule::Page{afterId, limit});
+        });
+    };
+}
@@ -43,3 +43,13 @@ void ActivityEntity::setId(int id)
 {
     m_id = id;
 }
+
+int ActivityEntity::version() const
+{
+    return m_version;
+}
+
+void ActivityEntity::setVersion(int version)
+{
+    m_version = version;
+}
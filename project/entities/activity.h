@@ -9,6 +9,8 @@ public:
 
     int id() const;
     void setId(int id);
+    int version() const;            // of the row the entity was read from
+    void setVersion(int version);
 
     QString type() const;
     void setType(const QString &type);
@@ -20,6 +22,7 @@ private:
     int     m_id;
     QString m_type;
     float   m_kkm; // kkal per kg per minute
+    int     m_version = 0;
 };
 
 class ActivityController {
@@ -1,66 +1,121 @@
 #include "entities/client.h"
 
+#include <utility>
+
+class ClientData : public QSharedData
+{
+public:
+    int _id = -1;
+    QString _name;
+    QString _surname;
+    QString _patronymic;
+    QDate _birthDate;
+    QChar _gender;
+    short _age = 0;
+    QString _telNumber;
+
+    bool _isInit = false;
+    int _version = 0;
+};
+
+namespace {
+
+const QSharedDataPointer<ClientData>& defaultData()
+{
+    static const QSharedDataPointer<ClientData> data(new ClientData);
+    return data;
+}
+
+} // namespace
+
+Client::Client()
+    :d(defaultData())
+{
+}
+
 Client::Client(int id, QString name, QString surname, QString patronymic,
                QDate birthDate, QChar gender, short age, QString telNumber)
-    :_id(id)
-    ,_name(name)
-    ,_surname(surname)
-    ,_patronymic(patronymic)
-    ,_birthDate(birthDate)
-    ,_gender(gender)
-    ,_age(age)
-    ,_telNumber(telNumber)
-    ,_isInit(true)
+    :d(new ClientData)
 {
+    d->_id = id;
+    d->_name = std::move(name);
+    d->_surname = std::move(surname);
+    d->_patronymic = std::move(patronymic);
+    d->_birthDate = birthDate;
+    d->_gender = gender;
+    d->_age = age;
+    d->_telNumber = std::move(telNumber);
+    d->_isInit = true;
 }
 
+Client::Client(const Client &other) = default;
+Client::Client(Client &&other) noexcept = default;
+Client &Client::operator=(const Client &other) = default;
+Client &Client::operator=(Client &&other) noexcept = default;
+Client::~Client() = default;
+
 int Client::id() const
 {
-    return _id;
+    return d->_id;
 }
 
-QString Client::name() const
+const QString& Client::name() const
 {
-    return _name;
+    return d->_name;
 }
 
-QString Client::surname() const
+const QString& Client::surname() const
 {
-    return _surname;
+    return d->_surname;
 }
 
 
-QString Client::patronymic() const
+const QString& Client::patronymic() const
 {
-    return _patronymic;
+    return d->_patronymic;
 }
 
 QDate Client::birthDate() const
 {
-    return _birthDate;
+    return d->_birthDate;
 }
 
 QChar Client::gender() const
 {
-    return _gender;
+    return d->_gender;
 }
 
 short Client::age() const
 {
-    return _age;
+    return d->_age;
 }
 
-QString Client::telNumber() const
+const QString& Client::telNumber() const
 {
-    return _telNumber;
+    return d->_telNumber;
 }
 
 void Client::setId(int id)
 {
-    _id = id;
+    d->_id = id;
 }
 
 bool Client::isInit() const
 {
-    return _isInit;
+    return d->_isInit;
+}
+
+int Client::version() const
+{
+    return d->_version;
+}
+
+int Client::dataSize()
+{
+    return int(sizeof(ClientData));
+}
+
+void Client::setVersion(int version)
+{
+    d->_version = version;
 }
@@ -1,36 +1,39 @@
 #pragma once
 #include <QString>
 #include <QDate>
+#include <QSharedDataPointer>
 
+class ClientData;
+
+/// Implicitly shared like ProductEntity
 class Client {
 public:
-    Client() = default;
+    Client();
     Client(int id, QString name, QString surname, QString patronymic,
            QDate birthDate, QChar gender, short age, QString telNumber
            );
+    Client(const Client& other);
+    Client(Client&& other) noexcept;
+    Client& operator=(const Client& other);
+    Client& operator=(Client&& other) noexcept;
+    ~Client();
 
     int id() const;
-    QString name() const;
-    QString surname() const;
-    QString patronymic() const;
+    const QString& name() const;
+    const QString& surname() const;
+    const QString& patronymic() const;
     QDate birthDate() const;
     QChar gender() const;
     short age() const;
-    QString telNumber() const;
+    const QString& telNumber() const;
 
     bool isInit() const;
+    int version() const;            // of the row the client was read from
+    static int dataSize();          // of the shared data without the text it owns
 
     void setId(int id);
+    void setVersion(int version);
 
 private:
-    int _id = -1;
-    QString _name;
-    QString _surname;
-    QString _patronymic;
-    QDate _birthDate;
-    QChar _gender;
-    short _age;
-    QString _telNumber;
-
-    bool _isInit = false;
+    QSharedDataPointer<ClientData> d;
 };
@@ -1,5 +1,7 @@
 #include "entities/examination.h"
 #include <QDebug>
+#include <QHash>
+#include <QLocale>
 
 Client Examination::client() const
 {
@@ -33,26 +35,49 @@ void Examination::setDate(const QDateTime &date)
 
 void Examination::setFieldValue(QString fieldName, QString value)
 {    
-    for (int i = 0; i < _fields.size(); ++i){
-        if (_fields[i].name() == fieldName) {
-            _fields[i].setValue(value);
-            return;
-        }
+    int number = fieldNumber(fieldName);
+    if (number == 0) {
+        qDebug() << "Error: Examination::setFieldValue(QString , QString)"
+                 << "Doesn't contain fieldName ";
+        return;
     }
+    setFieldValue(number, value);
+}
 
-//    foreach (FormField& field, _fields) {
-//        if (field.name() == fieldName) {
-//            field.setValue(value);
-//        }
-//    }
+void Examination::setFieldValue(int number, const QString &value)
+{
+    if (number < 1 || number > FIELD_COUNT) {
+        qDebug() << "Error:" << Q_FUNC_INFO << "Doesn't contain field" << number;
+        return;
+    }
+    if (_values.isEmpty()) {
+        _values.resize(FIELD_COUNT);
+    }
+    _values[number - 1] = value;
+}
 
-    qDebug() << "Error: Examination::setFieldValue(QString , QString)"
-             << "Doesn't contain fieldName ";
+int Examination::fieldNumber(const QString &fieldName)
+{
+    /// Built once, the names are looked up instead of compared one by one
+    static const QHash<QString, int> numbers = [](){
+        QHash<QString, int> byName;
+        for (int number = 1; number <= FIELD_COUNT; ++number) {
+            byName.insert(Examination::fieldName(number), number);
+        }
+        return byName;
+    }();
+    return numbers.value(fieldName, 0);
 }
 
-void Examination::initFields()
+QString Examination::fieldName(int number)
 {
-    _fields  = QVector<FormField>({
+    return QString("formfield_%1").arg(number);
+}
+
+const QVector<FormField> &Examination::schema()
+{
+    /// Built once and shared by all the examinations, which keep only the values
+    static const QVector<FormField> fields({
                                       { "formfield_1", FormField::UShort, "Пищевой анамнез 1 |  масса тела | колебания | мин." },
                                       { "formfield_2", FormField::UShort, "Пищевой анамнез 1 |  масса тела | колебания | макс." },
                                       { "formfield_3", FormField::UShort, "Пищевой анамнез 1 |  масса тела | в 20 лет" },
@@ -145,34 +170,76 @@ void Examination::initFields()
                                       { "formfield_90", FormField::String, "Заключение | дополнительно" },
 
                                   });
+    return fields;
 }
 
 FormField Examination::field(QString fieldName)
 {
-    for (int i = 0; i < _fields.size(); ++i){
-        if (_fields[i].name() == fieldName) {
-            return _fields[i];
-        }
+    int number = fieldNumber(fieldName);
+    return number == 0 ? FormField() : field(number);
+}
+
+FormField Examination::field(int number) const
+{
+    if (number < 1 || number > FIELD_COUNT) {
+        return FormField();
     }
+    FormField field = schema()[number - 1];
+    field.setValue(value(number));
+    return field;
+}
 
-//    foreach (FormField field, _fields) {
-//        if (field.name() == fieldName) {
-//            return field;
-//        }
-//    }
+QVector<FormField> Examination::fields() const
+{
+    QVector<FormField> fields = schema();
+    for (int i = 0; i < _values.size(); ++i) {
+        fields[i].setValue(_values[i]);
+    }
+    return fields;
+}
 
-    return FormField();
+QString Examination::value(int number) const
+{
+    return _values.value(number - 1);
+}
+
+double Examination::realValue(int number, bool *isOk) const
+{
+    return toReal(value(number), isOk);
+}
+
+double Examination::toReal(const QString &text, bool *isOk)
+{
+    /// Typed as "70.5" by the form or "70,5" in the locale of the user
+    bool isNumber = false;
+    double result = text.toDouble(&isNumber);
+    if (!isNumber) {
+        result = QLocale::system().toDouble(text, &isNumber);
+    }
+    if (isOk) {
+        *isOk = isNumber;
+    }
+    return isNumber ? result : 0;
 }
 
-QVector<FormField> Examination::fields()
+int Examination::intValue(int number, bool *isOk) const
 {
-    return _fields;
+    return value(number).trimmed().toInt(isOk);
 }
 
+QDate Examination::dateValue(int number) const
+{
+    return toDate(value(number));
+}
 
-Examination::Examination()
+QDate Examination::toDate(const QString &text)
 {
-    initFields();
+    /// Saved as ISO by the form; "ddMMyyyy" is how the form used to read it back
+    QDate date = QDate::fromString(text, Qt::ISODate);
+    if (!date.isValid()) {
+        date = QDate::fromString(text, "ddMMyyyy");
+    }
+    return date;
 }
 
 int Examination::id() const
@@ -185,6 +252,16 @@ void Examination::setId(int id)
     _id = id;
 }
 
+int Examination::version() const
+{
+    return _version;
+}
+
+void Examination::setVersion(int version)
+{
+    _version = version;
+}
+
 FormField::FormField(QString name, Type type, QString interpretation
                      , bool isMayBeEmpty)
         : _name(name), _type(type), _interpretation(interpretation)
@@ -32,28 +32,44 @@ private:
 
 class Examination {
 public:
+    /// The form fields are numbered: schema()[number - 1] is "formfield_<number>"
+    static constexpr int FIELD_COUNT = 90;
+    static const QVector<FormField>& schema();         // the names, types and captions without values
+    static int fieldNumber(const QString& fieldName);   // 0 if there is no such field
+    static QString fieldName(int number);
+    static double toReal(const QString& text, bool* isOk = nullptr);  // the rule of realValue()
+    static QDate toDate(const QString& text);          // the rule of dateValue()
 
-    Examination();
+    Examination() = default;
 
     int id() const;
     Client client() const;
     bool isFullExamination() const;
     QDateTime date() const;
-    FormField field(QString fieldName);
-    QVector<FormField> fields();
+    FormField field(QString fieldName);                 // by the name, see fieldNumber()
+    FormField field(int number) const;
+    QVector<FormField> fields() const;                  // schema() with the values of this examination
+    int version() const;                // of the row the examination was read from
+
+    /// Typed values of the fields by number, isOk is false for an empty or invalid value
+    QString value(int number) const;
+    double realValue(int number, bool* isOk = nullptr) const;
+    int intValue(int number, bool* isOk = nullptr) const;
+    QDate dateValue(int number) const;                  // invalid for an empty or invalid value
 
     void setId(int id);
+    void setVersion(int version);
     void setClient(Client client);
     void setIsFullExamination(bool isFullExamination);
     void setDate(const QDateTime &date);
     void setFieldValue(QString fieldName, QString value);
+    void setFieldValue(int number, const QString& value);
 
 private:
-    void initFields();
-
-    QVector<FormField> _fields;
-    int _id;
+    QVector<QString> _values;           // by number - 1, empty until a value is set
+    int _id = 0;
     Client _client;
-    bool _isFullExamination;
+    bool _isFullExamination = false;
     QDateTime _date;
+    int _version = 0;
 };
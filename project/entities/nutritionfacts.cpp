@@ -0,0 +1,30 @@
+#include "entities/nutritionfacts.h"
+
+NutritionFacts NutritionFacts::of(const QVector<WeightedProduct> &products)
+{
+    NutritionFacts total;
+    for (const WeightedProduct& ingredient : products) {
+        const ProductEntity& product = ingredient.product();
+        const float share = ingredient.amound() * 0.01f;
+        total.proteins += product.proteins() * share;
+        total.fats += product.fats() * share;
+        total.carbohydrates += product.carbohydrates() * share;
+        total.kilocalories += product.kilocalories() * share;
+        total.weight += ingredient.amound();
+    }
+    return total;
+}
+
+NutritionFacts NutritionFacts::per100Grams() const
+{
+    NutritionFacts result;
+    if (weight > 0) {
+        const float scale = 100.f / weight;
+        result.proteins = proteins * scale;
+        result.fats = fats * scale;
+        result.carbohydrates = carbohydrates * scale;
+        result.kilocalories = kilocalories * scale;
+        result.weight = 100.f;
+    }
+    return result;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <QVector>
+
+#include "product.h"
+
+/// Nutrients of a set of ingredients, the product values are per 100 g.
+/// A recipe has no portion count, so the totals are one portion.
+struct NutritionFacts {
+    float proteins = 0;
+    float fats = 0;
+    float carbohydrates = 0;
+    float kilocalories = 0;
+    float weight = 0;                   // of the ingredients
+
+    /// All the totals in one pass over the ingredients
+    static NutritionFacts of(const QVector<WeightedProduct>& products);
+
+    NutritionFacts per100Grams() const; // zeros if there is no weight
+};
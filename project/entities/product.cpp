@@ -1,14 +1,34 @@
 #include "entities/product.h"
 
+#include <utility>
+
+class ProductData : public QSharedData
+{
+public:
+    int m_id = -1;
+    QString m_name = "Unknown";
+    QString m_description = "none";
+    float m_proteins = 0;
+    float m_fats = 0;
+    float m_carbohydrates = 0;
+    float m_kilocalories = 0;
+    ProductEntity::UnitsType m_units = ProductEntity::UNDEF;
+    int m_version = 0;
+};
+
+namespace {
+
+/// One for all the default products, so resizing a vector of them allocates nothing
+const QSharedDataPointer<ProductData>& defaultData()
+{
+    static const QSharedDataPointer<ProductData> data(new ProductData);
+    return data;
+}
+
+} // namespace
+
 ProductEntity::ProductEntity()
-    :m_id(-1)
-    ,m_name("Unknown")
-    ,m_description("none")
-    ,m_proteins(0)
-    ,m_fats(0)
-    ,m_carbohydrates(0)
-    ,m_kilocalories(0)
-    ,m_units(UnitsType::UNDEF)
+    :d(defaultData())
 {
 }
 
@@ -20,69 +40,76 @@ ProductEntity::ProductEntity(int id
                             , float carbohydrates
                             , float kilocalories
                             , UnitsType units)
-    :m_id(id)
-    ,m_name(name)
-    ,m_description(description)
-    ,m_proteins(proteins)
-    ,m_fats(fats)
-    ,m_carbohydrates(carbohydrates)
-    ,m_kilocalories(kilocalories)
-    ,m_units(units)
+    :d(new ProductData)
 {
+    d->m_id = id;
+    d->m_name = std::move(name);
+    d->m_description = std::move(description);
+    d->m_proteins = proteins;
+    d->m_fats = fats;
+    d->m_carbohydrates = carbohydrates;
+    d->m_kilocalories = kilocalories;
+    d->m_units = units;
 }
 
-QString ProductEntity::name() const
+ProductEntity::ProductEntity(const ProductEntity &other) = default;
+ProductEntity::ProductEntity(ProductEntity &&other) noexcept = default;
+ProductEntity &ProductEntity::operator=(const ProductEntity &other) = default;
+ProductEntity &ProductEntity::operator=(ProductEntity &&other) noexcept = default;
+ProductEntity::~ProductEntity() = default;
+
+const QString& ProductEntity::name() const
 {
-    return m_name;
+    return d->m_name;
 }
 
-QString ProductEntity::description() const
+const QString& ProductEntity::description() const
 {
-    return m_description;
+    return d->m_description;
 }
 
 float ProductEntity::proteins() const
 {
-    return m_proteins;
+    return d->m_proteins;
 }
 
 float ProductEntity::fats() const
 {
-    return m_fats;
+    return d->m_fats;
 }
 
 float ProductEntity::carbohydrates() const
 {
-    return m_carbohydrates;
+    return d->m_carbohydrates;
 }
 
 float ProductEntity::kilocalories() const
 {
-    return m_kilocalories;
+    return d->m_kilocalories;
 }
 
 int ProductEntity::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
 void ProductEntity::setId(const int &id)
 {
-    m_id = id;
+    d->m_id = id;
 }
 
 ProductEntity::UnitsType ProductEntity::units() const
 {
-    return m_units;
+    return d->m_units;
 }
 
 WeightedProduct::WeightedProduct(ProductEntity product, int amound)
-    :m_product(product)
+    :m_product(std::move(product))
     ,m_amound(amound)
 {
 }
 
-ProductEntity WeightedProduct::product() const
+const ProductEntity& WeightedProduct::product() const
 {
     return m_product;
 }
@@ -96,3 +123,18 @@ void WeightedProduct::setAmound(unsigned int amound)
 {
     m_amound = amound;
 }
+
+int ProductEntity::version() const
+{
+    return d->m_version;
+}
+
+int ProductEntity::dataSize()
+{
+    return int(sizeof(ProductData));
+}
+
+void ProductEntity::setVersion(int version)
+{
+    d->m_version = version;
+}
@@ -1,6 +1,10 @@
 #pragma once
 #include <QString>
+#include <QSharedDataPointer>
 
+class ProductData;
+
+/// Implicitly shared: copies share the data until one of them is changed
 class ProductEntity
 {
 public:
@@ -14,28 +18,29 @@ public:
                  , float carbohydrates
                  , float kilocalories
                  , UnitsType units);
+    ProductEntity(const ProductEntity& other);
+    ProductEntity(ProductEntity&& other) noexcept;
+    ProductEntity& operator=(const ProductEntity& other);
+    ProductEntity& operator=(ProductEntity&& other) noexcept;
+    ~ProductEntity();
 
     int id() const;
-    QString name() const;
-    QString description() const;
+    const QString& name() const;
+    const QString& description() const;
     float proteins() const;
     float fats() const;
     float carbohydrates() const;
     float kilocalories() const;
     UnitsType units() const;
+    int version() const;             // of the row the entity was read from
+    static int dataSize();           // of the shared data without the text it owns
 
     void setId(const int &id);
+    void setVersion(int version);
 
 
 private:
-    int m_id;
-    QString m_name;
-    QString m_description;
-    float m_proteins;
-    float m_fats;
-    float m_carbohydrates;
-    float m_kilocalories;
-    UnitsType m_units;
+    QSharedDataPointer<ProductData> d;
 };
 
 class WeightedProduct {
@@ -45,7 +50,7 @@ public:
     WeightedProduct(ProductEntity product, int amound);
 
 public:
-    ProductEntity product() const;
+    const ProductEntity& product() const;
     int amound() const;
     void setAmound(unsigned int amound);
 
@@ -1,110 +1,162 @@
 #include "recipe.h"
+
+#include <utility>
+
+class RecipeData : public QSharedData
+{
+public:
+    int                       m_id = -1;
+    QString                   m_name = "Unknown";
+    QVector<WeightedProduct>  m_products;
+    QStringList               m_cookingPoints;
+    int                       m_version = 0;
+
+    /// Totals of the ingredients, kept up to date by every change of m_products
+    NutritionFacts            m_nutrition;
+
+    void recalculateTotals();
+};
+
+void RecipeData::recalculateTotals()
+{
+    m_nutrition = NutritionFacts::of(m_products);
+}
+
+namespace {
+
+const QSharedDataPointer<RecipeData>& defaultData()
+{
+    static const QSharedDataPointer<RecipeData> data(new RecipeData);
+    return data;
+}
+
+} // namespace
+
 RecipeEntity::RecipeEntity()
-    :m_id(-1)
-    ,m_name("Unknown")
+    :d(defaultData())
 {
 }
 
 RecipeEntity::RecipeEntity(int id, QString name, QVector<WeightedProduct> products, QStringList cookingPoints)
-    :m_id(id)
-    ,m_name(name)
-    ,m_products(products)
-    ,m_cookingPoints(cookingPoints)
+    :d(new RecipeData)
 {
+    d->m_id = id;
+    d->m_name = std::move(name);
+    d->m_products = std::move(products);
+    d->m_cookingPoints = std::move(cookingPoints);
+    d->recalculateTotals();
 }
 
+RecipeEntity::RecipeEntity(const RecipeEntity &other) = default;
+RecipeEntity::RecipeEntity(RecipeEntity &&other) noexcept = default;
+RecipeEntity &RecipeEntity::operator=(const RecipeEntity &other) = default;
+RecipeEntity &RecipeEntity::operator=(RecipeEntity &&other) noexcept = default;
+RecipeEntity::~RecipeEntity() = default;
+
 int RecipeEntity::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
-QString RecipeEntity::name() const
+const QString& RecipeEntity::name() const
 {
-    return m_name;
+    return d->m_name;
 }
 
-QVector<WeightedProduct> RecipeEntity::products() const
+const QVector<WeightedProduct>& RecipeEntity::products() const
 {
-    return m_products;
+    return d->m_products;
 }
 
-QStringList RecipeEntity::cookingPoints() const
+const QStringList& RecipeEntity::cookingPoints() const
 {
-    return m_cookingPoints;
+    return d->m_cookingPoints;
+}
+
+const NutritionFacts &RecipeEntity::nutrition() const
+{
+    return d->m_nutrition;
 }
 
 float RecipeEntity::proteins()const
 {
-    float proteins(0.f);
-    for (const auto& wp : m_products){
-        proteins += wp.product().proteins() * wp.amound() * 0.01;
-    }
-    return proteins;
+    return d->m_nutrition.proteins;
 }
 
 float RecipeEntity::fats()const
 {
-    float fats(0.f);
-    for (const auto& wp : m_products){
-        fats += wp.product().fats() * wp.amound() * 0.01;
-    }
-    return fats;
+    return d->m_nutrition.fats;
 }
 
 float RecipeEntity::carbohydrates()const
 {
-    float carbohydrates(0.f);
-    for (const auto& wp : m_products){
-        carbohydrates += wp.product().carbohydrates() * wp.amound() * 0.01;
-    }
-    return carbohydrates;
+    return d->m_nutrition.carbohydrates;
 }
 
 float RecipeEntity::kkal()const
 {
-    float kkal(0.f);
-    for (const auto& wp : m_products){
-        kkal += wp.product().kilocalories() * wp.amound() * 0.01;
-    }
-    return kkal;
+    return d->m_nutrition.kilocalories;
+}
+
+float RecipeEntity::weight() const
+{
+    return d->m_nutrition.weight;
 }
 
 void RecipeEntity::addProduct(WeightedProduct product, unsigned int index)
 {
-    m_products.insert(index, product);
+    d->m_products.insert(index, std::move(product));
+    d->recalculateTotals();
 }
 
 void RecipeEntity::deleteProduct(unsigned int index)
 {
-    m_products.erase(m_products.begin() + index);
+    d->m_products.erase(d->m_products.begin() + index);
+    d->recalculateTotals();
 }
 
 void RecipeEntity::addDescription(QString description, unsigned int index)
 {
-    m_cookingPoints.insert(index, description);
+    d->m_cookingPoints.insert(index, std::move(description));
 }
 
 void RecipeEntity::deleteDescription(unsigned int index)
 {
-    m_cookingPoints.erase(m_cookingPoints.begin() + index);
+    d->m_cookingPoints.erase(d->m_cookingPoints.begin() + index);
 }
 
 QVector<WeightedProduct> RecipeEntity::getPoducts()
 {
-    return m_products;
+    return d.constData()->m_products;
 }
 
 QStringList RecipeEntity::getCookingPoints()
 {
-    return m_cookingPoints;
+    return d.constData()->m_cookingPoints;
 }
 
 void RecipeEntity::setId(int id)
 {
-    m_id = id;
+    d->m_id = id;
 }
    
 void RecipeEntity::setProducts(const QVector<WeightedProduct> &p)
 {
-    m_products = p;
+    d->m_products = p;
+    d->recalculateTotals();
+}
+
+int RecipeEntity::version() const
+{
+    return d->m_version;
+}
+
+int RecipeEntity::dataSize()
+{
+    return int(sizeof(RecipeData));
+}
+
+void RecipeEntity::setVersion(int version)
+{
+    d->m_version = version;
 }
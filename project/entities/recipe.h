@@ -2,27 +2,42 @@
 #include <QString>
 #include <QStringList>
 #include <QVector>
+#include <QSharedDataPointer>
 
 #include "product.h"
+#include "nutritionfacts.h"
 
+class RecipeData;
+
+/// Implicitly shared like ProductEntity
 class RecipeEntity
 {
 public:
     RecipeEntity();
     RecipeEntity(int id, QString name, QVector<WeightedProduct> products, QStringList cookingPoints);
+    RecipeEntity(const RecipeEntity& other);
+    RecipeEntity(RecipeEntity&& other) noexcept;
+    RecipeEntity& operator=(const RecipeEntity& other);
+    RecipeEntity& operator=(RecipeEntity&& other) noexcept;
+    ~RecipeEntity();
 
     int id() const;
-    QString name() const;
-    QVector<WeightedProduct> products() const;
-    QStringList cookingPoints() const;
+    const QString& name() const;
+    const QVector<WeightedProduct>& products() const;
+    const QStringList& cookingPoints() const;
+    const NutritionFacts& nutrition() const;
     float proteins() const;
     float fats() const;
     float carbohydrates() const;
     float kkal() const;
+    float weight() const;                    // of all the ingredients
+    int version() const;                     // of the row the entity was read from
+    static int dataSize();                   // of the shared data without the vectors it owns
     QVector<WeightedProduct> getPoducts();
     QStringList getCookingPoints();
 
     void setId(int id);
+    void setVersion(int version);
     void setProducts(const QVector<WeightedProduct>& );
 
     void addProduct(WeightedProduct product, unsigned int index);
@@ -36,8 +51,5 @@ public:
 
 
 private:
-    int                       m_id;
-    QString                   m_name;
-    QVector<WeightedProduct>  m_products;
-    QStringList               m_cookingPoints;
+    QSharedDataPointer<RecipeData> d;
 };
@@ -0,0 +1,30 @@
+#pragma once
+#include <QString>
+#include <QDateTime>
+
+/// Rows of the search lists: the id and the displayed columns only.
+/// The full entity is loaded by id when a row is opened.
+
+struct ClientSummary {
+    int     id = -1;
+    QString surname;
+    QString name;
+    QString patronymic;
+};
+
+struct ExaminationSummary {
+    int             id = -1;
+    ClientSummary   client;
+    bool            isFullExamination = false;
+    QDateTime       date;
+};
+
+struct RecipeSummary {
+    int     id = -1;
+    QString name;
+    float   proteins = 0;       // totals stored in Recipes
+    float   fats = 0;
+    float   carbohydrates = 0;
+    float   kcal = 0;
+    float   weight = 0;         // of all the ingredients
+};
@@ -0,0 +1,162 @@
+#include "entitycache.h"
+
+#include <QMutexLocker>
+
+namespace {
+
+/// Approximate memory of an entity: the shared data behind the handle and the text and vectors it owns
+int textCost(const QString& text)
+{
+    return text.size() * int(sizeof(QChar));
+}
+
+int entityCost(const ProductEntity& product)
+{
+    return ProductEntity::dataSize() + textCost(product.name()) + textCost(product.description());
+}
+
+int entityCost(const RecipeEntity& recipe)
+{
+    int cost = RecipeEntity::dataSize() + textCost(recipe.name())
+             + recipe.products().size() * int(sizeof(WeightedProduct))
+             + recipe.cookingPoints().size() * int(sizeof(QString));
+    for (const WeightedProduct& product : recipe.products()) {
+        cost += entityCost(product.product());
+    }
+    for (const QString& point : recipe.cookingPoints()) {
+        cost += textCost(point);
+    }
+    return cost;
+}
+
+int entityCost(const ActivityEntity& activity)
+{
+    return int(sizeof(ActivityEntity)) + textCost(activity.type());
+}
+
+int entityCost(const Client& client)
+{
+    return Client::dataSize() + textCost(client.surname()) + textCost(client.name())
+         + textCost(client.patronymic()) + textCost(client.telNumber());
+}
+
+} // namespace
+
+EntityCache::EntityCache(int budget)
+    : m_entities(budget)
+{
+}
+
+void EntityCache::setBudget(int bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entities.setMaxCost(bytes);
+}
+
+EntityCache::Stats EntityCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.size = m_entities.size();
+    stats.cost = m_entities.totalCost();
+    stats.budget = m_entities.maxCost();
+    return stats;
+}
+
+quint64 EntityCache::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+bool EntityCache::find(int id, ProductEntity &product)
+{
+    return findEntity(ProductKind, id, product);
+}
+
+bool EntityCache::find(int id, RecipeEntity &recipe)
+{
+    return findEntity(RecipeKind, id, recipe);
+}
+
+bool EntityCache::find(int id, ActivityEntity &activity)
+{
+    return findEntity(ActivityKind, id, activity);
+}
+
+bool EntityCache::find(int id, Client &client)
+{
+    return findEntity(ClientKind, id, client);
+}
+
+void EntityCache::insert(const ProductEntity &product, quint64 generation)
+{
+    insertEntity(ProductKind, product.id(), product, entityCost(product), generation);
+}
+
+void EntityCache::insert(const RecipeEntity &recipe, quint64 generation)
+{
+    insertEntity(RecipeKind, recipe.id(), recipe, entityCost(recipe), generation);
+}
+
+void EntityCache::insert(const ActivityEntity &activity, quint64 generation)
+{
+    insertEntity(ActivityKind, activity.id(), activity, entityCost(activity), generation);
+}
+
+void EntityCache::insert(const Client &client, quint64 generation)
+{
+    insertEntity(ClientKind, client.id(), client, entityCost(client), generation);
+}
+
+void EntityCache::remove(Kind kind, int id)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_entities.remove(Key(kind, id));
+}
+
+void EntityCache::removeAll(Kind kind)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    for (const Key& key : m_entities.keys()) {
+        if (key.first == kind) {
+            m_entities.remove(key);
+        }
+    }
+}
+
+void EntityCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_entities.clear();
+}
+
+template <class T>
+bool EntityCache::findEntity(Kind kind, int id, T &entity)
+{
+    QMutexLocker locker(&m_mutex);
+    /// object() makes the entity the most recently used one
+    const Entity* cached = m_entities.object(Key(kind, id));
+    if (!cached) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    entity = std::get<T>(*cached);
+    return true;
+}
+
+void EntityCache::insertEntity(Kind kind, int id, const Entity &entity, int cost, quint64 generation)
+{
+    QMutexLocker locker(&m_mutex);
+    if (generation != m_generation) {
+        return;
+    }
+    /// QCache owns the copy and drops it at once if it is larger than the budget
+    m_entities.insert(Key(kind, id), new Entity(entity), cost);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <QCache>
+#include <QMutex>
+#include <variant>
+
+#include "entities/product.h"
+#include "entities/recipe.h"
+#include "entities/activity.h"
+#include "entities/client.h"
+
+/// Least recently used entities read by id, keyed by the type and the id.
+/// Shared by the connections of all threads; the writers remove what they change.
+/// The budget is the approximate memory of the cached entities in bytes.
+class EntityCache
+{
+public:
+    enum Kind : quint8 { ProductKind, RecipeKind, ActivityKind, ClientKind };
+
+    struct Stats {
+        int hits = 0;
+        int misses = 0;
+        int size = 0;
+        int cost = 0;                   // bytes
+        int budget = 0;                 // bytes
+    };
+
+    static constexpr int DEFAULT_BUDGET = 4 * 1024 * 1024;
+
+    explicit EntityCache(int budget = DEFAULT_BUDGET);
+
+    void setBudget(int bytes);          // evicts the least recently used entities above it
+    Stats stats() const;
+
+    quint64 generation() const;         // read before selecting the entity passed to insert()
+
+    bool find(int id, ProductEntity& product);
+    bool find(int id, RecipeEntity& recipe);
+    bool find(int id, ActivityEntity& activity);
+    bool find(int id, Client& client);
+
+    /// rejected if anything was removed after generation was read
+    void insert(const ProductEntity& product, quint64 generation);
+    void insert(const RecipeEntity& recipe, quint64 generation);
+    void insert(const ActivityEntity& activity, quint64 generation);
+    void insert(const Client& client, quint64 generation);
+
+    void remove(Kind kind, int id);
+    void removeAll(Kind kind);
+    void clear();
+
+private:
+    using Entity = std::variant<ProductEntity, RecipeEntity, ActivityEntity, Client>;
+    using Key = QPair<quint8, int>;     // (Kind, id)
+
+    mutable QMutex      m_mutex;
+    QCache<Key, Entity> m_entities;
+    quint64             m_generation = 0;
+    int                 m_hits = 0;
+    int                 m_misses = 0;
+
+    template <class T> bool findEntity(Kind kind, int id, T& entity);
+    void insertEntity(Kind kind, int id, const Entity& entity, int cost, quint64 generation);
+};
@@ -0,0 +1,152 @@
+#include "examinationtrends.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const int MEASURE_FIELDS[ExaminationTrends::MEASURE_COUNT] = { 47, 44, 45, 69, 78, 79 };
+
+} // namespace
+
+int ExaminationTrends::fieldNumber(Measure measure)
+{
+    return MEASURE_FIELDS[measure];
+}
+
+ExaminationTrends::Measure ExaminationTrends::measure(int fieldNumber)
+{
+    const int* found = std::find(std::begin(MEASURE_FIELDS), std::end(MEASURE_FIELDS), fieldNumber);
+    return Measure(found - std::begin(MEASURE_FIELDS));
+}
+
+QVector<int> ExaminationTrends::fieldNumbers()
+{
+    QVector<int> numbers;
+    for (int field : MEASURE_FIELDS) {
+        numbers << field;
+    }
+    return numbers;
+}
+
+const ExaminationTrends::Series &ExaminationTrends::series(Measure measure) const
+{
+    return m_series[measure];
+}
+
+double ExaminationTrends::delta(Measure measure) const
+{
+    const Series& points = m_series[measure];
+    return points.size() < 2 ? 0 : points.last().value - points.first().value;
+}
+
+double ExaminationTrends::lastChange(Measure measure) const
+{
+    const Series& points = m_series[measure];
+    return points.size() < 2 ? 0 : points.last().value - points[points.size() - 2].value;
+}
+
+bool ExaminationTrends::isEmpty() const
+{
+    return std::all_of(std::begin(m_series), std::end(m_series), [](const Series& points) {
+        return points.isEmpty();
+    });
+}
+
+void ExaminationTrends::add(int examinationId, const QDateTime &date, int fieldNumber, double value)
+{
+    const Measure index = measure(fieldNumber);
+    if (index == MEASURE_COUNT) {
+        return;
+    }
+    /// Loaded in the date order, so a point is usually appended
+    Series& points = m_series[index];
+    auto position = std::upper_bound(points.begin(), points.end(), qMakePair(date, examinationId),
+                                     [](const QPair<QDateTime, int>& key, const Point& point) {
+        return key.first < point.date || (key.first == point.date && key.second < point.examinationId);
+    });
+    points.insert(position, Point{ examinationId, date, value });
+}
+
+void ExaminationTrends::add(const Examination &examination)
+{
+    remove(examination.id());
+    for (int field : MEASURE_FIELDS) {
+        bool isNumber = false;
+        const double value = examination.realValue(field, &isNumber);
+        if (isNumber) {
+            add(examination.id(), examination.date(), field, value);
+        }
+    }
+}
+
+void ExaminationTrends::remove(int examinationId)
+{
+    for (Series& points : m_series) {
+        points.erase(std::remove_if(points.begin(), points.end(), [examinationId](const Point& point) {
+            return point.examinationId == examinationId;
+        }), points.end());
+    }
+}
+
+quint64 ExaminationTrendsCache::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+bool ExaminationTrendsCache::find(int clientId, ExaminationTrends &trends)
+{
+    QMutexLocker locker(&m_mutex);
+    const ExaminationTrends* cached = m_trends.object(clientId);
+    if (!cached) {
+        return false;
+    }
+    trends = *cached;
+    return true;
+}
+
+void ExaminationTrendsCache::insert(int clientId, const ExaminationTrends &trends, quint64 generation)
+{
+    QMutexLocker locker(&m_mutex);
+    if (generation != m_generation) {
+        return;
+    }
+    m_trends.insert(clientId, new ExaminationTrends(trends));
+}
+
+void ExaminationTrendsCache::merge(int clientId, const Examination &examination)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    ExaminationTrends* cached = m_trends.object(clientId);
+    if (cached) {
+        cached->add(examination);
+    }
+}
+
+void ExaminationTrendsCache::removeExamination(int clientId, int examinationId)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    ExaminationTrends* cached = m_trends.object(clientId);
+    if (cached) {
+        cached->remove(examinationId);
+    }
+}
+
+void ExaminationTrendsCache::remove(int clientId)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_trends.remove(clientId);
+}
+
+void ExaminationTrendsCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_generation;
+    m_trends.clear();
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QVector>
+
+#include "entities/examination.h"
+
+/// Measurements of one client's examinations as time series, the oldest first.
+/// Loaded from the typed columns of ExaminationValues, so the values are parsed once,
+/// and a saved examination is merged in without reading the others again.
+class ExaminationTrends
+{
+public:
+    enum Measure {
+        Weight,                         // formfield_47
+        Waist,                          // formfield_44
+        Hips,                           // formfield_45
+        BodyMassIndex,                  // formfield_69
+        Glucose,                        // formfield_78
+        Cholesterol,                    // formfield_79
+        MEASURE_COUNT
+    };
+
+    struct Point {
+        int         examinationId = -1;
+        QDateTime   date;
+        double      value = 0;
+    };
+    using Series = QVector<Point>;
+
+    static int fieldNumber(Measure measure);
+    static Measure measure(int fieldNumber);            // MEASURE_COUNT for the other fields
+    static QVector<int> fieldNumbers();                 // of all the measures
+
+    const Series& series(Measure measure) const;
+    double delta(Measure measure) const;                // the last value - the first one, 0 for less than 2 points
+    double lastChange(Measure measure) const;           // the last value - the previous one
+    bool isEmpty() const;
+
+    void add(int examinationId, const QDateTime& date, int fieldNumber, double value);
+    void add(const Examination& examination);           // replaces the points of the examination
+    void remove(int examinationId);
+
+private:
+    Series m_series[MEASURE_COUNT];
+};
+
+/// Trends of the recently opened clients by the client id.
+/// Shared by the connections of all threads like EntityCache.
+class ExaminationTrendsCache
+{
+public:
+    static constexpr int CAPACITY = 64;                 // clients
+
+    quint64 generation() const;                         // read before selecting the trends passed to insert()
+
+    bool find(int clientId, ExaminationTrends& trends);
+    void insert(int clientId, const ExaminationTrends& trends, quint64 generation);
+
+    void merge(int clientId, const Examination& examination);  // a saved examination, if the client is cached
+    void removeExamination(int clientId, int examinationId);
+    void remove(int clientId);
+    void clear();
+
+private:
+    mutable QMutex                  m_mutex;
+    QCache<int, ExaminationTrends>  m_trends { CAPACITY };
+    quint64                         m_generation = 0;
+};
@@ -4,7 +4,27 @@
 #include <QPainter>
 #include <QDebug>
 #include <QTextDocument>
+#include <QTextTable>
 
+#include "entities/nutritionfacts.h"
+
+namespace {
+
+/// A count or a year as a number, the text as typed if it is not one
+QString intText(const Examination& exm, int number)
+{
+    bool isOk = false;
+    const int value = exm.intValue(number, &isOk);
+    return isOk ? QString::number(value) : exm.value(number);
+}
+
+QString dateText(const Examination& exm, int number)
+{
+    const QDate date = exm.dateValue(number);
+    return date.isValid() ? date.toString("dd.MM.yyyy") : exm.value(number);
+}
+
+} // namespace
 
 Printer::Printer(QWidget *wgt)
     : QWidget(wgt)
@@ -50,6 +70,36 @@ void Printer::previewPageExamination(QPrinter *printer)
     document.print(printer);
 }
 
+void Printer::previewRecipe(const RecipeEntity &recipe, const QImage &image)
+{
+    _recipe = recipe;
+    _recipeImage = image;
+    _printer->setDocName(tr("Рецепт: %1").arg(recipe.name()));
+
+    QPrintPreviewDialog* dialog = new QPrintPreviewDialog(_printer, this);
+    dialog->setWindowFlags(Qt::Window);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle(tr("Рецепт: %1").arg(recipe.name()));
+    connect(dialog, SIGNAL(paintRequested(QPrinter*)), SLOT(previewPageRecipe(QPrinter*)));
+    dialog->exec();
+}
+
+void Printer::previewPageRecipe(QPrinter *printer)
+{
+    QTextDocument document;
+    document.setDefaultFont(QFont("Times New Roman"));
+    _cursor = QTextCursor(&document);
+
+    drawDocumentTitle(_recipe.name());
+    _cursor.insertBlock();
+    _cursor.insertBlock();
+    drawRecipeNutrition();
+    drawRecipeIngredients();
+    drawRecipeCookingPoints();
+
+    document.print(printer);
+}
+
 void Printer::drawHalfExamination()
 {
     drawDocumentTitle(tr("Консультация Нутрициолога-диетолога:"));
@@ -65,92 +115,92 @@ void Printer::drawHalfExamination()
     drawParagraphTitle(tr("Пищевой анамнез"));
 
     drawParagraph(tr("Колебания массы тела с %1 до %2 кг постепенно: %3 за период %4, при этом комфортная %5 кг, в 20 лет %6 кг")
-                  .arg(_exm.field("formfield_1").value())
-                  .arg(_exm.field("formfield_2").value())
-                  .arg(_exm.field("formfield_7").value())
-                  .arg(_exm.field("formfield_5").value())
-                  .arg(_exm.field("formfield_4").value())
-                  .arg(_exm.field("formfield_3").value())
+                  .arg(_exm.value(1))
+                  .arg(_exm.value(2))
+                  .arg(_exm.value(7))
+                  .arg(_exm.value(5))
+                  .arg(_exm.value(4))
+                  .arg(_exm.value(3))
                   );
     drawParagraph(tr("Наличие аппетита: %1, чувства голода: %2, насыщения: %3")
-                  .arg(_exm.field("formfield_10").value())
-                  .arg(_exm.field("formfield_11").value())
-                  .arg(_exm.field("formfield_12").value())
+                  .arg(_exm.value(10))
+                  .arg(_exm.value(11))
+                  .arg(_exm.value(12))
                   );
     drawParagraph(tr("Причины набора массы тела: %1")
-                  .arg(_exm.field("formfield_6").value())
+                  .arg(_exm.value(6))
                   );
     drawParagraph(tr("Изменение питания происходило постепенно: %1, использовались диеты: %2, голодание: %3, применялись пищевые добавки, лекарственные препараты: %4")
-                  .arg(_exm.field("formfield_7").value())
-                  .arg(_exm.field("formfield_8").value())
-                  .arg(_exm.field("formfield_9").value())
-                  .arg(_exm.field("formfield_13").value())
+                  .arg(_exm.value(7))
+                  .arg(_exm.value(8))
+                  .arg(_exm.value(9))
+                  .arg(_exm.value(13))
                   );
     drawParagraph(tr("Характер питания: %1 пищевые привычки: %2 переносимость продуктов: %3")
-                  .arg(_exm.field("formfield_14").value())
-                  .arg(_exm.field("formfield_15").value())
-                  .arg(_exm.field("formfield_16").value())
+                  .arg(_exm.value(14))
+                  .arg(_exm.value(15))
+                  .arg(_exm.value(16))
                   );
     drawParagraph(tr("Суточный рацион питания оценивается как: %1, двигательная активность: %2")
-                  .arg(_exm.field("formfield_17").value())
-                  .arg(_exm.field("formfield_19").value())
+                  .arg(_exm.value(17))
+                  .arg(_exm.value(19))
                   );
 
     drawParagraphTitle(tr("Анамнез жизни"));
 
     drawParagraph(tr("Жалобы в настоящий момент: %1, перенесенные заболевания: %2, хронические заболевания: %3, вредные привычки %4")
-                  .arg(_exm.field("formfield_20").value())
-                  .arg(_exm.field("formfield_21").value())
-                  .arg(_exm.field("formfield_22").value())
-                  .arg(_exm.field("formfield_23").value())
+                  .arg(_exm.value(20))
+                  .arg(_exm.value(21))
+                  .arg(_exm.value(22))
+                  .arg(_exm.value(23))
                   );
     drawParagraph(tr("Аллергический фон: %3, гормональный фон: %4 ")
-                  .arg(_exm.field("formfield_25").value())
-                  .arg(_exm.field("formfield_26").value())
+                  .arg(_exm.value(25))
+                  .arg(_exm.value(26))
                   );
 
     drawParagraphTitle(tr("Физикальный осмотр"));
 
     drawParagraph(tr("Кожа и подкожно жировая клетчатка: %1, волосы: %2, депигментация: %3, отеки: %4, мышечный слой: %5")
-                  .arg(_exm.field("formfield_37").value())
-                  .arg(_exm.field("formfield_39").value())
-                  .arg(_exm.field("formfield_38").value())
-                  .arg(_exm.field("formfield_40").value())
-                  .arg(_exm.field("formfield_41").value())
+                  .arg(_exm.value(37))
+                  .arg(_exm.value(39))
+                  .arg(_exm.value(38))
+                  .arg(_exm.value(40))
+                  .arg(_exm.value(41))
                   );
 
     drawParagraphTitle(tr("Антропометрия"));
 
     drawParagraph(tr("Длина тела %1 см, масса тела %2 кг, индекс массы тела %3 кг/м2, рекомендуемая масса тела %4 кг")
-                  .arg(_exm.field("formfield_46").value())
-                  .arg(_exm.field("formfield_47").value())
-                  .arg(_exm.field("formfield_69").value())
-                  .arg(_exm.field("formfield_75").value())
+                  .arg(_exm.value(46))
+                  .arg(_exm.value(47))
+                  .arg(_exm.value(69))
+                  .arg(_exm.value(75))
                   );
     drawParagraph(tr("Окружность талии %1, тазового пояса %2 см, соотношение %3, окружность запястья %4 см")
-                  .arg(_exm.field("formfield_44").value())
-                  .arg(_exm.field("formfield_45").value())
-                  .arg(_exm.field("formfield_71").value())
-                  .arg(_exm.field("formfield_51").value())
+                  .arg(_exm.value(44))
+                  .arg(_exm.value(45))
+                  .arg(_exm.value(71))
+                  .arg(_exm.value(51))
                   );
 
     drawParagraphTitle(tr("Биохимические показатели"));
 
     drawParagraph(tr("Глюкоза: %1, холестерин: %2.")
-                  .arg(_exm.field("formfield_78").value())
-                  .arg(_exm.field("formfield_79").value())
+                  .arg(_exm.value(78))
+                  .arg(_exm.value(79))
                   );
 
     drawParagraphTitle(tr("Заключение"));
 
     drawParagraph(tr("Нутриционный статус: %1, масса тела: %2, ожирение: %3 степени, метаболический синдром: %4.")
-                  .arg(_exm.field("formfield_85").value())
-                  .arg(_exm.field("formfield_87").value())
-                  .arg(_exm.field("formfield_88").value())
-                  .arg(_exm.field("formfield_86").value())
+                  .arg(_exm.value(85))
+                  .arg(_exm.value(87))
+                  .arg(_exm.value(88))
+                  .arg(_exm.value(86))
                   );
     drawParagraph(tr("Дополнительно: %1")
-                  .arg(_exm.field("formfield_90").value())
+                  .arg(_exm.value(90))
                   );
 }
 
@@ -167,160 +217,231 @@ void Printer::drawFullExamination()
 
     drawParagraphTitle(tr("Пищевой анамнез"));
     drawParagraph(tr("Колебания массы тела с %1 до %2 кг постепенно: %3 за период %4, при этом комфортная %5 кг, в 20 лет %6 кг")
-                  .arg(_exm.field("formfield_1").value())
-                  .arg(_exm.field("formfield_2").value())
-                  .arg(_exm.field("formfield_7").value())
-                  .arg(_exm.field("formfield_5").value())
-                  .arg(_exm.field("formfield_4").value())
-                  .arg(_exm.field("formfield_3").value())
+                  .arg(_exm.value(1))
+                  .arg(_exm.value(2))
+                  .arg(_exm.value(7))
+                  .arg(_exm.value(5))
+                  .arg(_exm.value(4))
+                  .arg(_exm.value(3))
                   );
     drawParagraph(tr("Наличие аппетита: %1, чувства голода: %2, насыщения: %3")
-                  .arg(_exm.field("formfield_10").value())
-                  .arg(_exm.field("formfield_11").value())
-                  .arg(_exm.field("formfield_12").value())
+                  .arg(_exm.value(10))
+                  .arg(_exm.value(11))
+                  .arg(_exm.value(12))
                   );
     drawParagraph(tr("Причины набора массы тела: %1")
-                  .arg(_exm.field("formfield_6").value())
+                  .arg(_exm.value(6))
                   );
     drawParagraph(tr("Изменение питания происходило постепенно: %1, использовались диеты: %2, голодание: %3, применялись пищевые добавки, лекарственные препараты: %4")
-                  .arg(_exm.field("formfield_7").value())
-                  .arg(_exm.field("formfield_8").value())
-                  .arg(_exm.field("formfield_9").value())
-                  .arg(_exm.field("formfield_13").value())
+                  .arg(_exm.value(7))
+                  .arg(_exm.value(8))
+                  .arg(_exm.value(9))
+                  .arg(_exm.value(13))
                   );
     drawParagraph(tr("Характер питания: %1 пищевые привычки: %2 переносимость продуктов: %3")
-                  .arg(_exm.field("formfield_14").value())
-                  .arg(_exm.field("formfield_15").value())
-                  .arg(_exm.field("formfield_16").value())
+                  .arg(_exm.value(14))
+                  .arg(_exm.value(15))
+                  .arg(_exm.value(16))
                   );
     drawParagraph(tr("Суточный рацион питания оценивается как: %1, пищевой дневник: %2, двигательная активность: %3")
-                  .arg(_exm.field("formfield_17").value())
-                  .arg(_exm.field("formfield_18").value())
-                  .arg(_exm.field("formfield_19").value())
+                  .arg(_exm.value(17))
+                  .arg(_exm.value(18))
+                  .arg(_exm.value(19))
                   );
 
     drawParagraphTitle(tr("Анамнез жизни"));
     drawParagraph(tr("Жалобы в настоящий момент: %1, перенесенные заболевания: %2, хронические заболевания: %3, вредные привычки %4")
-                  .arg(_exm.field("formfield_20").value())
-                  .arg(_exm.field("formfield_21").value())
-                  .arg(_exm.field("formfield_22").value())
-                  .arg(_exm.field("formfield_23").value())
+                  .arg(_exm.value(20))
+                  .arg(_exm.value(21))
+                  .arg(_exm.value(22))
+                  .arg(_exm.value(23))
                   );
     drawParagraph(tr("Семейное положение: %1, наследственность отягощена: (дети: %2),  аллергический фон: %3, гормональный фон: %4 ")
-                  .arg(_exm.field("formfield_28").value())
-                  .arg(_exm.field("formfield_27").value())
-                  .arg(_exm.field("formfield_25").value())
-                  .arg(_exm.field("formfield_26").value())
+                  .arg(_exm.value(28))
+                  .arg(_exm.value(27))
+                  .arg(_exm.value(25))
+                  .arg(_exm.value(26))
                   );
 
     if(_exm.client().gender() == 'f'){
         drawParagraphTitle(tr("Гинекологический и акушерский анамнез "));
         drawParagraph(tr("Детей: %1, беременностей: %2, родов: %3 ")
-                      .arg(_exm.field("formfield_27").value())
-                      .arg(_exm.field("formfield_35").value())
-                      .arg(_exm.field("formfield_36").value())
+                      .arg(intText(_exm, 27))
+                      .arg(intText(_exm, 35))
+                      .arg(intText(_exm, 36))
                       );
         drawParagraph(tr("Менструальный цикл: длится %1 дней, периодичность %2, дата последней %3, безболезненный %4. Менопауза наступила в %5 году, характер %6")
-                      .arg(_exm.field("formfield_30").value())
-                      .arg(_exm.field("formfield_31").value())
-                      .arg(_exm.field("formfield_29").value())
-                      .arg(_exm.field("formfield_32").value())
-                      .arg(_exm.field("formfield_33").value())
-                      .arg(_exm.field("formfield_36").value())
+                      .arg(intText(_exm, 30))
+                      .arg(intText(_exm, 31))
+                      .arg(dateText(_exm, 29))
+                      .arg(_exm.value(32))
+                      .arg(intText(_exm, 33))
+                      .arg(_exm.value(36))
                       );
     }
 
     drawParagraphTitle(tr("Физикальный осмотр"));
     drawParagraph(tr("Кожа и подкожно жировая клетчатка: %1, волосы: %2, депигментация: %3, отеки: %4, мышечный слой: %5")
-                  .arg(_exm.field("formfield_37").value())
-                  .arg(_exm.field("formfield_39").value())
-                  .arg(_exm.field("formfield_38").value())
-                  .arg(_exm.field("formfield_40").value())
-                  .arg(_exm.field("formfield_41").value())
+                  .arg(_exm.value(37))
+                  .arg(_exm.value(39))
+                  .arg(_exm.value(38))
+                  .arg(_exm.value(40))
+                  .arg(_exm.value(41))
                   );
 
     drawParagraphTitle(tr("Антропометрия"));
     drawParagraph(tr("Длина тела: %1 см. Масса тела %2 кг. Индекс массы тела: %3 кг/м2.")
-                  .arg(_exm.field("formfield_46").value())
-                  .arg(_exm.field("formfield_47").value())
-                  .arg(_exm.field("formfield_69").value())
+                  .arg(_exm.value(46))
+                  .arg(_exm.value(47))
+                  .arg(_exm.value(69))
                   );
     drawParagraph(tr("Окружность: шеи: %1 см, грудной клетки: %2 см, талии: %3 см, тазового пояса: %4 см, плеча: %5/%6 см, предплечья: %7/%8 см, бедра: %9/%10 см, голени: %11/%12 см ")
-                  .arg(_exm.field("formfield_42").value())
-                  .arg(_exm.field("formfield_43").value())
-                  .arg(_exm.field("formfield_44").value())
-                  .arg(_exm.field("formfield_45").value())
-                  .arg(_exm.field("formfield_48").value())
-                  .arg(_exm.field("formfield_49").value())
-                  .arg(_exm.field("formfield_50").value())
-                  .arg(_exm.field("formfield_51").value())
-                  .arg(_exm.field("formfield_52").value())
-                  .arg(_exm.field("formfield_53").value())
-                  .arg(_exm.field("formfield_54").value())
-                  .arg(_exm.field("formfield_55").value())
+                  .arg(_exm.value(42))
+                  .arg(_exm.value(43))
+                  .arg(_exm.value(44))
+                  .arg(_exm.value(45))
+                  .arg(_exm.value(48))
+                  .arg(_exm.value(49))
+                  .arg(_exm.value(50))
+                  .arg(_exm.value(51))
+                  .arg(_exm.value(52))
+                  .arg(_exm.value(53))
+                  .arg(_exm.value(54))
+                  .arg(_exm.value(55))
                   );
 
     drawParagraphTitle(tr("Физиометрия"));
     drawParagraph(tr("Динамометрия правой: %1 левой: %2 кг. Силовой индекс: %3")
-                  .arg(_exm.field("formfield_66").value())
-                  .arg(_exm.field("formfield_67").value())
-                  .arg(_exm.field("formfield_72").value())
+                  .arg(_exm.value(66))
+                  .arg(_exm.value(67))
+                  .arg(_exm.value(72))
                   );
     drawParagraph(tr("ЖЕЛ: %1 мл. Жизненный индекс: %2")
-                  .arg(_exm.field("formfield_68").value())
-                  .arg(_exm.field("formfield_72").value())
+                  .arg(_exm.value(68))
+                  .arg(_exm.value(72))
                   );
     drawParagraph(tr("ЧСС в покое: %1 уд/мин, после нагрузки: %2 уд/мин")
-                  .arg(_exm.field("formfield_62").value())
-                  .arg(_exm.field("formfield_63").value())
+                  .arg(_exm.value(62))
+                  .arg(_exm.value(63))
                   );
     drawParagraph(tr("АД в покое: %1/%2 мм.рт.ст., после нагрузки: %3/%4 мм.рт.ст.")
-                  .arg(_exm.field("formfield_56").value())
-                  .arg(_exm.field("formfield_58").value())
-                  .arg(_exm.field("formfield_57").value())
-                  .arg(_exm.field("formfield_59").value())
+                  .arg(_exm.value(56))
+                  .arg(_exm.value(58))
+                  .arg(_exm.value(57))
+                  .arg(_exm.value(59))
                   );
     drawParagraph(tr("Реституция: %1 сек.")
-                  .arg(_exm.field("formfield_63").value())
+                  .arg(_exm.value(63))
                   );
     drawParagraph(tr("Результаты пробы  Мартинэ-Кушелеского: %1, индекса Руфье: %2, Робинсона: %3")
-                  .arg(_exm.field("formfield_65").value())
-                  .arg(_exm.field("formfield_70").value())
-                  .arg(_exm.field("formfield_74").value())
+                  .arg(_exm.value(65))
+                  .arg(_exm.value(70))
+                  .arg(_exm.value(74))
                   );
     drawParagraph(tr("Рекомендуемая масса тела: %1 кг")
-                  .arg(_exm.field("formfield_75").value())
+                  .arg(_exm.value(75))
                   );
     drawParagraph(tr("Уровень физического здоровья: %1, адаптационного потенциала: %2.")
-                  .arg(_exm.field("formfield_76").value())
-                  .arg(_exm.field("formfield_77").value())
+                  .arg(_exm.value(76))
+                  .arg(_exm.value(77))
                   );
 
     drawParagraphTitle(tr("Биохимические показатели"));
     drawParagraph(tr("Глюкоза: %1, холестерин: %2, общий белок: %3, креатин: %4, мочевая кислота: %5, лептин: %6")
-                  .arg(_exm.field("formfield_78").value())
-                  .arg(_exm.field("formfield_79").value())
-                  .arg(_exm.field("formfield_80").value())
-                  .arg(_exm.field("formfield_81").value())
-                  .arg(_exm.field("formfield_82").value())
-                  .arg(_exm.field("formfield_83").value())
+                  .arg(_exm.value(78))
+                  .arg(_exm.value(79))
+                  .arg(_exm.value(80))
+                  .arg(_exm.value(81))
+                  .arg(_exm.value(82))
+                  .arg(_exm.value(83))
                   );
     drawParagraph(tr("Дополнительные: %1")
-                  .arg(_exm.field("formfield_84").value())
+                  .arg(_exm.value(84))
                   );
 
     drawParagraphTitle(tr("Заключение"));
     drawParagraph(tr("Нутриционный статус: %1, масса тела: %2, ожирение: %3 степени, метаболический синдром: %4.")
-                  .arg(_exm.field("formfield_85").value())
-                  .arg(_exm.field("formfield_87").value())
-                  .arg(_exm.field("formfield_88").value())
-                  .arg(_exm.field("formfield_86").value())
+                  .arg(_exm.value(85))
+                  .arg(_exm.value(87))
+                  .arg(_exm.value(88))
+                  .arg(_exm.value(86))
                   );
     drawParagraph(tr("Дополнительно: %1")
-                  .arg(_exm.field("formfield_90").value())
+                  .arg(_exm.value(90))
                   );
 }
 
+void Printer::drawRecipeNutrition()
+{
+    /// A recipe has no portion count, the whole recipe is one portion
+    const NutritionFacts& portion = _recipe.nutrition();
+    const NutritionFacts per100Grams = portion.per100Grams();
+
+    QTextTable *table = _cursor.insertTable(1, 2);
+    QTextCursor cellCursor = table->cellAt(0, 0).firstCursorPosition();
+    cellCursor.insertImage(_recipeImage.scaled(280, 280));
+
+    cellCursor = table->cellAt(0, 1).firstCursorPosition();
+    cellCursor.insertText(tr("ЭНЕРГЕТИЧЕСКАЯ ЦЕННОСТЬ"));
+    cellCursor.insertBlock();
+    cellCursor.insertBlock();
+
+    const QString titles[] = { tr("КАЛОРИЙНОСТЬ, ккал"), tr("БЕЛКИ, грамм"), tr("ЖИРЫ, грамм"), tr("УГЛЕВОДЫ, грамм") };
+    const float portionValues[] = { portion.kilocalories, portion.proteins, portion.fats, portion.carbohydrates };
+    const float per100GramsValues[] = { per100Grams.kilocalories, per100Grams.proteins,
+                                        per100Grams.fats, per100Grams.carbohydrates };
+
+    QTextTable *subTable = cellCursor.insertTable(5, 3);
+    subTable->cellAt(0, 1).firstCursorPosition().insertText(tr("НА ПОРЦИЮ"));
+    subTable->cellAt(0, 2).firstCursorPosition().insertText(tr("НА 100 Г"));
+    for (int i = 0; i < 4; ++i) {
+        subTable->cellAt(i + 1, 0).firstCursorPosition().insertText(titles[i]);
+        subTable->cellAt(i + 1, 1).firstCursorPosition().insertText(QString::number(portionValues[i]));
+        subTable->cellAt(i + 1, 2).firstCursorPosition().insertText(QString::number(per100GramsValues[i]));
+    }
+
+    //cellCursor.insertText("* КАЛОРИЙНОСТЬ РАССЧИТАНА ДЛЯ СЫРЫХ ПРОДУКТОВ");
+    _cursor.movePosition(QTextCursor::End);
+}
+
+void Printer::drawRecipeIngredients()
+{
+    _cursor.insertBlock();
+    _cursor.insertBlock();
+    _cursor.insertText(tr("ИНГРЕДИЕНТЫ"));
+    _cursor.insertBlock();
+
+    const QVector<WeightedProduct>& products = _recipe.products();
+    _cursor.insertTable(products.size(), 3);
+    for (const auto& product : products){
+        _cursor.insertText(product.product().name());
+        _cursor.movePosition(QTextCursor::NextCell);
+        _cursor.insertText(QString::number(product.amound()));
+        _cursor.movePosition(QTextCursor::NextCell);
+        _cursor.insertText(product.product().units() == ProductEntity::GRAMM ? "гр" : product.product().units() == ProductEntity::MILLILITER ? "мл" : "???");
+        _cursor.movePosition(QTextCursor::NextCell);
+    }
+    _cursor.movePosition(QTextCursor::End);
+}
+
+void Printer::drawRecipeCookingPoints()
+{
+    _cursor.insertBlock();
+    _cursor.insertBlock();
+    _cursor.insertText(tr("ИНСТРУКЦИЯ ПРИГОТОВЛЕНИЯ"));
+    _cursor.insertBlock();
+
+    const QStringList& cookingPoints = _recipe.cookingPoints();
+    _cursor.insertTable(cookingPoints.size(), 2);
+    for (int i = 0; i < cookingPoints.size(); ++ i){
+        _cursor.insertText(QString::number(i+1));
+        _cursor.movePosition(QTextCursor::NextCell);
+        _cursor.insertText(cookingPoints.at(i));
+        _cursor.movePosition(QTextCursor::NextCell);
+    }
+    _cursor.movePosition(QTextCursor::End);
+}
+
 void Printer::drawParagraphTitle(const QString& s)
 {
     QTextCharFormat boldWeight;
@@ -7,6 +7,7 @@
 #include <QPaintDevice>
 #include <QPrintPreviewDialog>
 #include <QTextCursor>
+#include <QImage>
 
 class Printer : public QWidget
 {
@@ -16,9 +17,11 @@ public:
     virtual ~Printer();
 
     void previewExamination(const Examination& , bool isFullReport);
+    void previewRecipe(const RecipeEntity& , const QImage& image);
 
 private slots:
     void previewPageExamination(QPrinter*);
+    void previewPageRecipe(QPrinter*);
 
 private:
     void drawHalfExamination();
@@ -26,9 +29,14 @@ private:
     void drawParagraphTitle(const QString& );
     void drawParagraph(const QString& );
     void drawDocumentTitle(const QString& );
+    void drawRecipeNutrition();             // per portion and per 100 g, from one NutritionFacts
+    void drawRecipeIngredients();
+    void drawRecipeCookingPoints();
 
     Examination _exm;
     bool _isFullReport;
+    RecipeEntity _recipe;
+    QImage _recipeImage;
     QPrinter* _printer;
 
     QTextCursor _cursor;
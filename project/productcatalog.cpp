@@ -0,0 +1,108 @@
+#include "productcatalog.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+
+quint64 ProductCatalog::generation() const
+{
+    QReadLocker locker(&m_lock);
+    return m_generation;
+}
+
+bool ProductCatalog::isLoaded() const
+{
+    QReadLocker locker(&m_lock);
+    return m_isLoaded;
+}
+
+bool ProductCatalog::load(const QVector<ProductEntity> &products, quint64 generation)
+{
+    QWriteLocker locker(&m_lock);
+    if (generation != m_generation) {
+        return false;
+    }
+
+    m_products = products;
+    m_ids.resize(products.size());
+    m_proteins.resize(products.size());
+    m_fats.resize(products.size());
+    m_carbohydrates.resize(products.size());
+    m_kilocalories.resize(products.size());
+    for (int i = 0; i < products.size(); ++i) {
+        m_ids[i] = products[i].id();
+        m_proteins[i] = products[i].proteins();
+        m_fats[i] = products[i].fats();
+        m_carbohydrates[i] = products[i].carbohydrates();
+        m_kilocalories[i] = products[i].kilocalories();
+    }
+
+    m_nameIndex.clear();
+    for (int i = 0; i < products.size(); ++i) {
+        m_nameIndex.add(i, products[i].name(), products[i].description());
+    }
+    m_nameIndex.build();
+    m_isLoaded = true;
+    return true;
+}
+
+void ProductCatalog::invalidate()
+{
+    QWriteLocker locker(&m_lock);
+    ++m_generation;
+    m_isLoaded = false;
+    m_products.clear();
+    m_ids.clear();
+    m_proteins.clear();
+    m_fats.clear();
+    m_carbohydrates.clear();
+    m_kilocalories.clear();
+    m_nameIndex.clear();
+}
+
+QVector<ProductEntity> ProductCatalog::products(const Filter &filter, int afterId, int limit) const
+{
+    QReadLocker locker(&m_lock);
+    QVector<ProductEntity> result;
+
+    /// The block masks are filled without branches, only the matches are copied
+    uchar isMatch[SCAN_BLOCK];
+    const int count = m_ids.size();
+    int begin = std::upper_bound(m_ids.cbegin(), m_ids.cend(), afterId) - m_ids.cbegin();
+    for (; begin < count && (limit < 0 || result.size() < limit); begin += SCAN_BLOCK) {
+        const int size = std::min(SCAN_BLOCK, count - begin);
+        scan(filter, begin, size, isMatch);
+        for (int i = 0; i < size && (limit < 0 || result.size() < limit); ++i) {
+            if (isMatch[i]) {
+                result << m_products[begin + i];
+            }
+        }
+    }
+    return result;
+}
+
+QVector<ProductEntity> ProductCatalog::search(const QString &text, int limit) const
+{
+    QReadLocker locker(&m_lock);
+    QVector<ProductEntity> result;
+    for (int row : m_nameIndex.find(text, limit)) {
+        result << m_products[row];
+    }
+    return result;
+}
+
+void ProductCatalog::scan(const Filter &filter, int begin, int size, uchar *isMatch) const
+{
+    const float* proteins = m_proteins.constData() + begin;
+    const float* fats = m_fats.constData() + begin;
+    const float* carbohydrates = m_carbohydrates.constData() + begin;
+    const float* kilocalories = m_kilocalories.constData() + begin;
+
+    for (int i = 0; i < size; ++i) {
+        isMatch[i] = (proteins[i] >= filter.proteins.from) & (proteins[i] <= filter.proteins.to)
+                   & (fats[i] >= filter.fats.from) & (fats[i] <= filter.fats.to)
+                   & (carbohydrates[i] >= filter.carbohydrates.from) & (carbohydrates[i] <= filter.carbohydrates.to)
+                   & (kilocalories[i] >= filter.kilocalories.from) & (kilocalories[i] <= filter.kilocalories.to);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <QVector>
+#include <QReadWriteLock>
+#include <limits>
+
+#include "entities/product.h"
+#include "searchindex.h"
+
+/// Products kept in memory for the nutrient range and the name searches. The nutrients
+/// are stored column by column, a filter is a branchless scan the compiler vectorizes.
+/// Shared by the connections of all threads, dropped by every write to Products.
+class ProductCatalog
+{
+public:
+    struct Range {                      // inclusive, unbounded by default
+        float from = -std::numeric_limits<float>::infinity();
+        float to   =  std::numeric_limits<float>::infinity();
+    };
+
+    struct Filter {                     // all the ranges must match
+        Range proteins;
+        Range fats;
+        Range carbohydrates;
+        Range kilocalories;
+    };
+
+    quint64 generation() const;         // read before selecting the rows passed to load()
+    bool isLoaded() const;
+
+    /// products in the id order; rejected if the catalog was invalidated after generation was read
+    bool load(const QVector<ProductEntity>& products, quint64 generation);
+    void invalidate();
+
+    /// Matching products with id > afterId in the id order, limit < 0 - all of them
+    QVector<ProductEntity> products(const Filter& filter, int afterId = 0, int limit = -1) const;
+
+    /// Products with all the words in the name or the description, the best first
+    QVector<ProductEntity> search(const QString& text, int limit = -1) const;
+
+private:
+    static constexpr int SCAN_BLOCK = 1024;
+
+    mutable QReadWriteLock  m_lock;
+    quint64                 m_generation = 0;
+    bool                    m_isLoaded = false;
+
+    QVector<ProductEntity>  m_products;
+    QVector<int>            m_ids;
+    QVector<float>          m_proteins;
+    QVector<float>          m_fats;
+    QVector<float>          m_carbohydrates;
+    QVector<float>          m_kilocalories;
+    SearchIndex             m_nameIndex;        // rows of m_products
+
+    void scan(const Filter& filter, int begin, int size, uchar* isMatch) const;
+};
@@ -30,6 +30,13 @@ SOURCES += main.cpp \
     windows/ProductEdit.cpp \
     windows/ActivityCalculation.cpp \
     databasemodule.cpp \
+    databaseworker.cpp \
+    entitycache.cpp \
+    examinationtrends.cpp \
+    productcatalog.cpp \
+    recipecatalog.cpp \
+    searchindex.cpp \
+    schemamigrator.cpp \
     MDIProgram.cpp \
     printer.cpp \
     entities/client.cpp \
@@ -37,6 +44,7 @@ SOURCES += main.cpp \
     entities/activity.cpp \
     entities/recipe.cpp \
     entities/product.cpp \
+    entities/nutritionfacts.cpp \
     widgets/AttachPhotoWidget.cpp
 
 HEADERS += \
@@ -56,7 +64,16 @@ HEADERS += \
     windows/ProductInfo.h \
     windows/ProductEdit.h \
     windows/ActivityCalculation.h \
+    windows/PagedTableModel.h \
     databasemodule.h \
+    databaseworker.h \
+    databasereply.h \
+    entitycache.h \
+    examinationtrends.h \
+    productcatalog.h \
+    recipecatalog.h \
+    searchindex.h \
+    schemamigrator.h \
     MDIProgram.h \
     windows.h \
     printer.h \
@@ -65,6 +82,8 @@ HEADERS += \
     entities/activity.h \
     entities/recipe.h \
     entities/product.h \
+    entities/nutritionfacts.h \
+    entities/summaries.h \
     widgets/AttachPhotoWidget.h
 
 FORMS += \
@@ -0,0 +1,122 @@
+#include "recipecatalog.h"
+#include "entities/nutritionfacts.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+
+quint64 RecipeCatalog::generation() const
+{
+    QReadLocker locker(&m_lock);
+    return m_generation;
+}
+
+bool RecipeCatalog::isLoaded() const
+{
+    QReadLocker locker(&m_lock);
+    return m_isLoaded;
+}
+
+bool RecipeCatalog::load(const QVector<RecipeSummary> &recipes, quint64 generation)
+{
+    QWriteLocker locker(&m_lock);
+    if (generation != m_generation) {
+        return false;
+    }
+
+    m_recipes = recipes;
+    m_ids.resize(recipes.size());
+    for (Columns* columns : { &m_perPortion, &m_per100Grams }) {
+        columns->proteins.resize(recipes.size());
+        columns->fats.resize(recipes.size());
+        columns->carbohydrates.resize(recipes.size());
+        columns->kilocalories.resize(recipes.size());
+    }
+    for (int i = 0; i < recipes.size(); ++i) {
+        const RecipeSummary& recipe = recipes[i];
+        m_ids[i] = recipe.id;
+        m_perPortion.proteins[i] = recipe.proteins;
+        m_perPortion.fats[i] = recipe.fats;
+        m_perPortion.carbohydrates[i] = recipe.carbohydrates;
+        m_perPortion.kilocalories[i] = recipe.kcal;
+
+        NutritionFacts totals;
+        totals.proteins = recipe.proteins;
+        totals.fats = recipe.fats;
+        totals.carbohydrates = recipe.carbohydrates;
+        totals.kilocalories = recipe.kcal;
+        totals.weight = recipe.weight;
+        const NutritionFacts per100Grams = totals.per100Grams();
+        m_per100Grams.proteins[i] = per100Grams.proteins;
+        m_per100Grams.fats[i] = per100Grams.fats;
+        m_per100Grams.carbohydrates[i] = per100Grams.carbohydrates;
+        m_per100Grams.kilocalories[i] = per100Grams.kilocalories;
+    }
+
+    m_nameIndex.clear();
+    for (int i = 0; i < recipes.size(); ++i) {
+        m_nameIndex.add(i, recipes[i].name);
+    }
+    m_nameIndex.build();
+    m_isLoaded = true;
+    return true;
+}
+
+void RecipeCatalog::invalidate()
+{
+    QWriteLocker locker(&m_lock);
+    ++m_generation;
+    m_isLoaded = false;
+    m_recipes.clear();
+    m_ids.clear();
+    m_perPortion = Columns();
+    m_per100Grams = Columns();
+    m_nameIndex.clear();
+}
+
+QVector<RecipeSummary> RecipeCatalog::recipes(const Filter &filter, int afterId, int limit) const
+{
+    QReadLocker locker(&m_lock);
+    QVector<RecipeSummary> result;
+
+    uchar isMatch[SCAN_BLOCK];
+    const int count = m_ids.size();
+    int begin = std::upper_bound(m_ids.cbegin(), m_ids.cend(), afterId) - m_ids.cbegin();
+    for (; begin < count && (limit < 0 || result.size() < limit); begin += SCAN_BLOCK) {
+        const int size = std::min(SCAN_BLOCK, count - begin);
+        scan(filter, begin, size, isMatch);
+        for (int i = 0; i < size && (limit < 0 || result.size() < limit); ++i) {
+            if (isMatch[i]) {
+                result << m_recipes[begin + i];
+            }
+        }
+    }
+    return result;
+}
+
+QVector<RecipeSummary> RecipeCatalog::search(const QString &text, int limit) const
+{
+    QReadLocker locker(&m_lock);
+    QVector<RecipeSummary> result;
+    for (int row : m_nameIndex.find(text, limit)) {
+        result << m_recipes[row];
+    }
+    return result;
+}
+
+void RecipeCatalog::scan(const Filter &filter, int begin, int size, uchar *isMatch) const
+{
+    const Columns& columns = filter.basis == Per100Grams ? m_per100Grams : m_perPortion;
+    const float* proteins = columns.proteins.constData() + begin;
+    const float* fats = columns.fats.constData() + begin;
+    const float* carbohydrates = columns.carbohydrates.constData() + begin;
+    const float* kilocalories = columns.kilocalories.constData() + begin;
+
+    for (int i = 0; i < size; ++i) {
+        isMatch[i] = (proteins[i] >= filter.proteins.from) & (proteins[i] <= filter.proteins.to)
+                   & (fats[i] >= filter.fats.from) & (fats[i] <= filter.fats.to)
+                   & (carbohydrates[i] >= filter.carbohydrates.from) & (carbohydrates[i] <= filter.carbohydrates.to)
+                   & (kilocalories[i] >= filter.kilocalories.from) & (kilocalories[i] <= filter.kilocalories.to);
+    }
+}
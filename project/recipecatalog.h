@@ -0,0 +1,64 @@
+#pragma once
+#include <QVector>
+#include <QReadWriteLock>
+
+#include "entities/summaries.h"
+#include "productcatalog.h"
+#include "searchindex.h"
+
+/// Recipe list rows kept in memory for the name and the nutrient range searches.
+/// The totals are stored column by column, per portion and per 100 g, like in ProductCatalog.
+/// Shared by the connections of all threads, dropped by every write to Recipes.
+class RecipeCatalog
+{
+public:
+    using Range = ProductCatalog::Range;
+
+    enum Basis {
+        PerPortion,                     // the whole recipe
+        Per100Grams                     // the totals per 100 of the ingredients weight
+    };
+
+    struct Filter {                     // all the ranges must match
+        Range proteins;
+        Range fats;
+        Range carbohydrates;
+        Range kilocalories;
+        Basis basis = PerPortion;
+    };
+
+    quint64 generation() const;         // read before selecting the rows passed to load()
+    bool isLoaded() const;
+
+    /// recipes in the id order; rejected if the catalog was invalidated after generation was read
+    bool load(const QVector<RecipeSummary>& recipes, quint64 generation);
+    void invalidate();
+
+    /// Matching recipes with id > afterId in the id order, limit < 0 - all of them
+    QVector<RecipeSummary> recipes(const Filter& filter, int afterId = 0, int limit = -1) const;
+
+    /// Recipes with all the words in the name, the best first
+    QVector<RecipeSummary> search(const QString& text, int limit = -1) const;
+
+private:
+    static constexpr int SCAN_BLOCK = 1024;
+
+    struct Columns {
+        QVector<float> proteins;
+        QVector<float> fats;
+        QVector<float> carbohydrates;
+        QVector<float> kilocalories;
+    };
+
+    mutable QReadWriteLock  m_lock;
+    quint64                 m_generation = 0;
+    bool                    m_isLoaded = false;
+
+    QVector<RecipeSummary>  m_recipes;
+    QVector<int>            m_ids;
+    Columns                 m_perPortion;
+    Columns                 m_per100Grams;      // 0 for the recipes without ingredients
+    SearchIndex             m_nameIndex;        // rows of m_recipes
+
+    void scan(const Filter& filter, int begin, int size, uchar* isMatch) const;
+};
@@ -0,0 +1,140 @@
+#include "schemamigrator.h"
+
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlError>
+#include <QElapsedTimer>
+#include <QVariant>
+#include <QDebug>
+
+#include <algorithm>
+
+SchemaMigrator::SchemaMigrator(const QSqlDatabase &db)
+    : _db(db)
+{
+}
+
+void SchemaMigrator::addMigration(const Migration &migration)
+{
+    auto position = std::upper_bound(m_migrations.begin(), m_migrations.end(), migration,
+                                     [](const Migration& a, const Migration& b) {
+                                         return a.version < b.version;
+                                     });
+    m_migrations.insert(position, migration);
+}
+
+int SchemaMigrator::currentVersion() const
+{
+    QSqlQuery q(_db);
+    if (!q.exec("PRAGMA user_version") || !q.next()) {
+        qDebug() << "Error:" << Q_FUNC_INFO
+                 << q.lastError().text();
+        return -1;
+    }
+    return q.value(0).toInt();
+}
+
+int SchemaMigrator::latestVersion() const
+{
+    return m_migrations.isEmpty() ? 0 : m_migrations.last().version;
+}
+
+bool SchemaMigrator::migrate(bool isDryRun)
+{
+    m_report.clear();
+    m_isDryRun = isDryRun;
+
+    const int version = currentVersion();
+    if (version < 0) {
+        return false;
+    }
+
+    if (isDryRun && !_db.transaction()) {
+        qDebug() << "Error:" << Q_FUNC_INFO
+                 << _db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery q(_db);
+    for (const Migration& migration : m_migrations) {
+        if (migration.version <= version) {
+            continue;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        StepReport step{ migration.version, migration.description, Applied, 0, QString() };
+
+        if (!isDryRun && !_db.transaction()) {
+            step.status = Failed;
+            step.error = _db.lastError().text();
+            m_report << step;
+            return false;
+        }
+
+        /// The savepoint lets an optional step be undone without losing the previous ones
+        bool isOk = q.exec("SAVEPOINT migration");
+        for (int i = 0; isOk && i < migration.statements.size(); ++i) {
+            isOk = q.exec(migration.statements[i]);
+        }
+        if (!isOk) {
+            step.error = q.lastError().text();
+            q.exec("ROLLBACK TO migration");
+        }
+        q.exec("RELEASE migration");
+
+        if (!isOk && !migration.isOptional) {
+            step.status = Failed;
+            step.elapsedMs = timer.elapsed();
+            m_report << step;
+            q.finish();
+            _db.rollback();
+            return false;
+        }
+        if (!isOk) {
+            step.status = Skipped;
+        }
+
+        if (!q.exec(QString("PRAGMA user_version = %1").arg(migration.version))
+                || (!isDryRun && !_db.commit())) {
+            step.status = Failed;
+            step.error = q.lastError().isValid() ? q.lastError().text() : _db.lastError().text();
+            step.elapsedMs = timer.elapsed();
+            m_report << step;
+            q.finish();
+            _db.rollback();
+            return false;
+        }
+        step.elapsedMs = timer.elapsed();
+        m_report << step;
+    }
+    q.finish();
+
+    if (isDryRun) {
+        _db.rollback();
+    }
+    return true;
+}
+
+QVector<SchemaMigrator::StepReport> SchemaMigrator::report() const
+{
+    return m_report;
+}
+
+QStringList SchemaMigrator::reportText() const
+{
+    QStringList lines;
+    for (const StepReport& step : m_report) {
+        QString status = step.status == Applied ? "applied"
+                       : step.status == Skipped ? "skipped" : "failed";
+        QString line = QString("%1v%2 %3: %4 in %5 ms")
+                .arg(m_isDryRun ? "[dry run] " : "")
+                .arg(step.version)
+                .arg(step.description, status)
+                .arg(step.elapsedMs);
+        if (!step.error.isEmpty()) {
+            line += " (" + step.error + ")";
+        }
+        lines << line;
+    }
+    return lines;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtSql/QSqlDatabase>
+
+/// Brings a database schema up to date with ordered migration steps.
+/// The number of the last applied step is kept in `PRAGMA user_version`.
+class SchemaMigrator
+{
+public:
+    struct Migration {
+        int         version;            // steps are applied in ascending order, starting after user_version
+        QString     description;
+        QStringList statements;
+        bool        isOptional = false; // a failed optional step is rolled back and skipped
+    };
+
+    enum StepStatus { Applied, Skipped, Failed };
+
+    struct StepReport {
+        int         version;
+        QString     description;
+        StepStatus  status;
+        qint64      elapsedMs;
+        QString     error;
+    };
+
+    explicit SchemaMigrator(const QSqlDatabase& db);
+
+    void addMigration(const Migration& );
+    int currentVersion() const;         // -1 if the version can not be read
+    int latestVersion() const;
+
+    /// Every pending step runs in its own transaction.
+    /// A dry run executes the same steps in one transaction and rolls it back.
+    bool migrate(bool isDryRun = false);
+
+    QVector<StepReport> report() const;
+    QStringList reportText() const;
+
+private:
+    QSqlDatabase        _db;
+    QVector<Migration>  m_migrations;
+    QVector<StepReport> m_report;
+    bool                m_isDryRun = false;
+};
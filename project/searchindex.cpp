@@ -0,0 +1,108 @@
+#include "searchindex.h"
+
+#include <QHash>
+#include <QPair>
+
+#include <algorithm>
+
+void SearchIndex::clear()
+{
+    m_entries.clear();
+}
+
+void SearchIndex::add(int row, const QString &name, const QString &description)
+{
+    addWords(row, name, NameField);
+    addWords(row, description, DescriptionField);
+}
+
+void SearchIndex::build()
+{
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) {
+        return a.word < b.word;
+    });
+}
+
+QVector<int> SearchIndex::find(const QString &text, int limit) const
+{
+    QStringList queryWords = words(text);
+    queryWords.removeDuplicates();
+    if (queryWords.isEmpty()) {
+        return QVector<int>();
+    }
+
+    /// Score of a word in a row: name word 4, name prefix 3, description word 2, description prefix 1
+    QHash<int, int> scores;
+    for (int i = 0; i < queryWords.size(); ++i) {
+        const QString& queryWord = queryWords[i];
+        QHash<int, int> wordScores;
+        auto it = std::lower_bound(m_entries.cbegin(), m_entries.cend(), queryWord,
+                                   [](const Entry& entry, const QString& word) {
+                                       return entry.word < word;
+                                   });
+        for (; it != m_entries.cend() && it->word.startsWith(queryWord); ++it) {
+            int score = (it->field == NameField ? 2 : 0) + (it->word.size() == queryWord.size() ? 2 : 1);
+            int& best = wordScores[it->row];
+            best = std::max(best, score);
+        }
+
+        /// Every word has to match
+        if (i == 0) {
+            scores = wordScores;
+        } else {
+            for (auto score = scores.begin(); score != scores.end(); ) {
+                auto wordScore = wordScores.constFind(score.key());
+                if (wordScore == wordScores.cend()) {
+                    score = scores.erase(score);
+                } else {
+                    score.value() += wordScore.value();
+                    ++score;
+                }
+            }
+        }
+        if (scores.isEmpty()) {
+            return QVector<int>();
+        }
+    }
+
+    QVector<QPair<int, int>> ranked;        // (score, row)
+    ranked.reserve(scores.size());
+    for (auto score = scores.cbegin(); score != scores.cend(); ++score) {
+        ranked << qMakePair(score.value(), score.key());
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<int, int>& a, const QPair<int, int>& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    const int count = limit < 0 ? ranked.size() : std::min(limit, ranked.size());
+    QVector<int> rows(count);
+    for (int i = 0; i < count; ++i) {
+        rows[i] = ranked[i].second;
+    }
+    return rows;
+}
+
+QStringList SearchIndex::words(const QString &text)
+{
+    QStringList result;
+    QString word;
+    for (QChar ch : text.toCaseFolded()) {
+        if (ch.isLetterOrNumber()) {
+            word += ch == QChar(0x0451) ? QChar(0x0435) : ch;      // ё -> е
+        } else if (!word.isEmpty()) {
+            result << word;
+            word.clear();
+        }
+    }
+    if (!word.isEmpty()) {
+        result << word;
+    }
+    return result;
+}
+
+void SearchIndex::addWords(int row, const QString &text, Field field)
+{
+    for (const QString& word : words(text)) {
+        m_entries << Entry{ word, row, field };
+    }
+}
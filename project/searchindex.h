@@ -0,0 +1,34 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/// Word prefix index over the names and descriptions of a list of rows.
+/// Words are case folded and 'ё' is matched as 'е'. A query matches a row
+/// if every query word starts a word of the row; rows matched in the name
+/// and by whole words rank first. Not synchronized, the owner locks it.
+class SearchIndex
+{
+public:
+    void clear();
+    void add(int row, const QString& name, const QString& description = QString());
+    void build();                       // sorts the words, call after the last add()
+
+    /// Matching rows, the best first, each row once; limit < 0 - all of them
+    QVector<int> find(const QString& text, int limit = -1) const;
+
+    static QStringList words(const QString& text);
+
+private:
+    enum Field : quint8 { NameField, DescriptionField };
+
+    struct Entry {
+        QString word;
+        int     row;
+        Field   field;
+    };
+
+    QVector<Entry> m_entries;           // in the word order after build()
+
+    void addWords(int row, const QString& text, Field field);
+};
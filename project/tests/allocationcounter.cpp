@@ -0,0 +1,141 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+
+namespace {
+
+std::atomic<qint64> allocationTotal{ 0 };
+std::atomic<qint64> bytesInUse{ 0 };
+
+} // namespace
+
+#if defined(__GLIBC__)
+#include <cerrno>
+#include <malloc.h>
+#include <unistd.h>
+
+/// The allocator of glibc, the replacements below count and pass the calls to it
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* block, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void  __libc_free(void* block);
+}
+
+namespace {
+
+void* counted(void* block)
+{
+    if (block) {
+        allocationTotal.fetch_add(1, std::memory_order_relaxed);
+        bytesInUse.fetch_add(qint64(malloc_usable_size(block)), std::memory_order_relaxed);
+    }
+    return block;
+}
+
+void released(void* block)
+{
+    if (block) {
+        bytesInUse.fetch_sub(qint64(malloc_usable_size(block)), std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) noexcept
+{
+    return counted(__libc_malloc(size));
+}
+
+void* calloc(size_t count, size_t size) noexcept
+{
+    return counted(__libc_calloc(count, size));
+}
+
+void* realloc(void* block, size_t size) noexcept
+{
+    const qint64 oldBytes = block ? qint64(malloc_usable_size(block)) : 0;
+    void* moved = __libc_realloc(block, size);
+    if (moved || size == 0) {           // realloc(block, 0) frees the block
+        bytesInUse.fetch_sub(oldBytes, std::memory_order_relaxed);
+    }
+    return counted(moved);
+}
+
+void free(void* block) noexcept
+{
+    released(block);
+    __libc_free(block);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+    return counted(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void** block, size_t alignment, size_t size) noexcept
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* aligned = counted(__libc_memalign(alignment, size));
+    if (!aligned) {
+        return ENOMEM;
+    }
+    *block = aligned;
+    return 0;
+}
+
+void* valloc(size_t size) noexcept
+{
+    return counted(__libc_memalign(size_t(sysconf(_SC_PAGESIZE)), size));
+}
+
+void* pvalloc(size_t size) noexcept
+{
+    const size_t page = size_t(sysconf(_SC_PAGESIZE));
+    return counted(__libc_memalign(page, (size + page - 1) / page * page));
+}
+
+} // extern "C"
+
+bool AllocationCounter::isAvailable()
+{
+    return true;
+}
+#else
+bool AllocationCounter::isAvailable()
+{
+    return false;
+}
+#endif
+
+AllocationCounter::AllocationCounter()
+{
+    restart();
+}
+
+void AllocationCounter::restart()
+{
+    m_allocations = allocationTotal.load(std::memory_order_relaxed);
+    m_bytes = bytesInUse.load(std::memory_order_relaxed);
+}
+
+qint64 AllocationCounter::allocations() const
+{
+    return allocationTotal.load(std::memory_order_relaxed) - m_allocations;
+}
+
+qint64 AllocationCounter::bytes() const
+{
+    return bytesInUse.load(std::memory_order_relaxed) - m_bytes;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <QtGlobal>
+
+/// Heap blocks allocated by the process, for the memory and allocation benchmarks.
+/// On glibc malloc() and its siblings are replaced in the test executable, so the blocks
+/// of the Qt containers are counted, not only the ones of operator new.
+/// Counts all the threads; nothing else should run while a benchmark measures.
+class AllocationCounter
+{
+public:
+    static bool isAvailable();          // false where malloc() is not replaced, the counts stay 0
+
+    AllocationCounter();                // starts counting
+    void restart();
+
+    qint64 allocations() const;         // blocks allocated since the start
+    qint64 bytes() const;               // growth of the bytes in use since the start, negative if freed
+
+private:
+    qint64 m_allocations = 0;
+    qint64 m_bytes = 0;
+};
@@ -0,0 +1,44 @@
+QT       += core sql testlib
+QT       -= gui
+
+TARGET = tst_benchmarks
+TEMPLATE = app
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ..
+
+SOURCES += tst_benchmarks.cpp \
+    allocationcounter.cpp \
+    ../databasemodule.cpp \
+    ../entitycache.cpp \
+    ../examinationtrends.cpp \
+    ../productcatalog.cpp \
+    ../recipecatalog.cpp \
+    ../searchindex.cpp \
+    ../schemamigrator.cpp \
+    ../entities/client.cpp \
+    ../entities/examination.cpp \
+    ../entities/activity.cpp \
+    ../entities/recipe.cpp \
+    ../entities/product.cpp \
+    ../entities/nutritionfacts.cpp
+
+HEADERS += \
+    allocationcounter.h \
+    ../databasemodule.h \
+    ../entitycache.h \
+    ../examinationtrends.h \
+    ../productcatalog.h \
+    ../recipecatalog.h \
+    ../searchindex.h \
+    ../schemamigrator.h \
+    ../entities/client.h \
+    ../entities/examination.h \
+    ../entities/activity.h \
+    ../entities/recipe.h \
+    ../entities/product.h \
+    ../entities/nutritionfacts.h \
+    ../entities/summaries.h
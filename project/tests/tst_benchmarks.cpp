@@ -0,0 +1,782 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlQuery>
+#include <algorithm>
+#include <memory>
+
+#include "allocationcounter.h"
+#include "databasemodule.h"
+#include "productcatalog.h"
+#include "recipecatalog.h"
+#include "searchindex.h"
+#include "entities/nutritionfacts.h"
+
+namespace {
+
+/// The paths the optimized code replaced, kept here as the baselines of the benchmarks
+/// and as the reference results of the equivalence tests.
+namespace baseline {
+
+ProductEntity product(unsigned id)
+{
+    QSqlQuery q;
+    q.prepare("SELECT * FROM Products WHERE id=?");
+    q.addBindValue(id);
+    if (!q.exec() || !q.next()) {
+        return ProductEntity();
+    }
+    return ProductEntity(int(id), q.value("name").toString(), q.value("description").toString()
+                         , q.value("proteins").toFloat(), q.value("fats").toFloat()
+                         , q.value("carbohydrates").toFloat(), q.value("kkal").toFloat()
+                         , static_cast<ProductEntity::UnitsType>(q.value("units").toInt()));
+}
+
+/// One query for the ids, then one per product
+QVector<ProductEntity> products()
+{
+    QVector<ProductEntity> products;
+    QSqlQuery q("SELECT id FROM Products");
+    while (q.next()) {
+        products << product(q.value("id").toUInt());
+    }
+    return products;
+}
+
+/// The name, the ingredients with one query per product, the cooking points
+RecipeEntity recipe(unsigned id)
+{
+    QSqlQuery q;
+    q.prepare("SELECT name FROM Recipes WHERE id=?");
+    q.addBindValue(id);
+    if (!q.exec() || !q.next()) {
+        return RecipeEntity();
+    }
+    const QString name = q.value("name").toString();
+
+    QSqlQuery q2;
+    q2.prepare("SELECT product_id, amound FROM ProductsInRecipes WHERE recipe_id=?");
+    q2.addBindValue(id);
+    q2.exec();
+    QVector<WeightedProduct> ingredients;
+    while (q2.next()) {
+        ingredients << WeightedProduct(product(q2.value("product_id").toUInt()), int(q2.value("amound").toDouble()));
+    }
+
+    QSqlQuery q3;
+    q3.prepare("SELECT description FROM CookingPoints WHERE recipe_id=? ORDER BY point_num");
+    q3.addBindValue(id);
+    q3.exec();
+    QStringList cookingPoints;
+    while (q3.next()) {
+        cookingPoints << q3.value("description").toString();
+    }
+    return RecipeEntity(int(id), name, ingredients, cookingPoints);
+}
+
+QVector<RecipeEntity> recipes()
+{
+    QVector<RecipeEntity> recipes;
+    QSqlQuery q("SELECT id FROM Recipes");
+    while (q.next()) {
+        recipes << recipe(q.value("id").toUInt());
+    }
+    return recipes;
+}
+
+/// One query for the ids, then one examination at a time, each fetching its client again
+QVector<Examination> examinations(const DatabaseModule& db, const Client& client)
+{
+    QVector<Examination> examinations;
+    QSqlQuery q;
+    q.prepare("SELECT id FROM Examinations WHERE client_id=?");
+    q.addBindValue(client.id());
+    q.exec();
+    while (q.next()) {
+        bool isOk = false;
+        Examination examination = db.examination(q.value("id").toInt(), isOk);
+        if (isOk) {
+            examinations << examination;
+        }
+    }
+    return examinations;
+}
+
+/// The range query the product windows ran before the catalog
+QVector<int> productIds(const char* column, QPair<float,float> interval)
+{
+    QVector<int> ids;
+    QSqlQuery q;
+    q.prepare(QString("SELECT id FROM Products WHERE %1 BETWEEN ? AND ? ORDER BY id").arg(column));
+    q.addBindValue(interval.first);
+    q.addBindValue(interval.second);
+    q.exec();
+    while (q.next()) {
+        ids << q.value("id").toInt();
+    }
+    return ids;
+}
+
+/// Every row against every query word, the rule SearchIndex::find() implements
+QVector<int> find(const QVector<ProductEntity>& products, const QString& text)
+{
+    const QStringList queryWords = SearchIndex::words(text);
+    QVector<int> rows;
+    for (int row = 0; row < products.size(); ++row) {
+        const QStringList rowWords = SearchIndex::words(products[row].name() + ' ' + products[row].description());
+        const bool isMatch = std::all_of(queryWords.cbegin(), queryWords.cend(), [&](const QString& queryWord) {
+            return std::any_of(rowWords.cbegin(), rowWords.cend(), [&](const QString& word) {
+                return word.startsWith(queryWord);
+            });
+        });
+        if (isMatch) {
+            rows << row;
+        }
+    }
+    return rows;
+}
+
+/// A pass over the ingredients for every total, as the recipe getters did
+NutritionFacts nutritionFacts(const QVector<WeightedProduct>& products)
+{
+    NutritionFacts facts;
+    for (const WeightedProduct& wp : products) {
+        facts.proteins += wp.product().proteins() * wp.amound() * 0.01f;
+    }
+    for (const WeightedProduct& wp : products) {
+        facts.fats += wp.product().fats() * wp.amound() * 0.01f;
+    }
+    for (const WeightedProduct& wp : products) {
+        facts.carbohydrates += wp.product().carbohydrates() * wp.amound() * 0.01f;
+    }
+    for (const WeightedProduct& wp : products) {
+        facts.kilocalories += wp.product().kilocalories() * wp.amound() * 0.01f;
+    }
+    for (const WeightedProduct& wp : products) {
+        facts.weight += wp.amound();
+    }
+    return facts;
+}
+
+/// Copies that share nothing with the source, what copying costs without implicit sharing
+ProductEntity deepCopy(const ProductEntity& product)
+{
+    return ProductEntity(product.id(), QString(product.name().constData(), product.name().size())
+                         , QString(product.description().constData(), product.description().size())
+                         , product.proteins(), product.fats(), product.carbohydrates(), product.kilocalories()
+                         , product.units());
+}
+
+RecipeEntity deepCopy(const RecipeEntity& recipe)
+{
+    QVector<WeightedProduct> ingredients;
+    ingredients.reserve(recipe.products().size());
+    for (const WeightedProduct& wp : recipe.products()) {
+        ingredients << WeightedProduct(deepCopy(wp.product()), wp.amound());
+    }
+    QStringList cookingPoints;
+    cookingPoints.reserve(recipe.cookingPoints().size());
+    for (const QString& point : recipe.cookingPoints()) {
+        cookingPoints << QString(point.constData(), point.size());
+    }
+    return RecipeEntity(recipe.id(), QString(recipe.name().constData(), recipe.name().size())
+                        , ingredients, cookingPoints);
+}
+
+/// An examination as it was kept before the schema was shared: every object built
+/// all the form fields, each with its own name, value and caption
+struct FormFieldExamination {
+    int                 id = 0;
+    Client              client;
+    bool                isFullExamination = false;
+    QDateTime           date;
+    QVector<FormField>  fields;
+
+    FormFieldExamination()
+    {
+        fields.reserve(Examination::FIELD_COUNT);
+        for (const FormField& field : Examination::schema()) {
+            fields << FormField(QString(field.name().constData(), field.name().size()), field.type()
+                                , QString(field.interpretation().constData(), field.interpretation().size())
+                                , field.isMayBeEmpty());
+        }
+    }
+};
+
+} // namespace baseline
+
+/// A positive count from the environment, so the fixture can be scaled without rebuilding
+int countFromEnvironment(const char* name, int defaultValue)
+{
+    bool isOk = false;
+    const int count = qEnvironmentVariableIntValue(name, &isOk);
+    return isOk && count > 0 ? count : defaultValue;
+}
+
+/// What a typeahead asks while the name is typed
+const QStringList TYPEAHEAD_PREFIXES = { "м", "мо", "мол", "молоко с", "молоко сы" };
+
+QVector<QPair<int,int>> ingredientIds(const RecipeEntity& recipe)     // product id and amount, sorted
+{
+    QVector<QPair<int,int>> ids;
+    for (const WeightedProduct& wp : recipe.products()) {
+        ids << qMakePair(wp.product().id(), wp.amound());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+/// Heap bytes held by count examinations with all the fields filled, either layout
+qint64 examinationBytes(int count, bool isFormFieldLayout)
+{
+    Examination::schema();              // built once, not a cost of the examinations
+    AllocationCounter counter;
+    qint64 bytes = 0;
+    if (isFormFieldLayout) {
+        QVector<baseline::FormFieldExamination> examinations(count);
+        for (baseline::FormFieldExamination& examination : examinations) {
+            for (int i = 0; i < examination.fields.size(); ++i) {
+                examination.fields[i].setValue(QString::number(i));
+            }
+        }
+        bytes = counter.bytes();
+    } else {
+        QVector<Examination> examinations(count);
+        for (Examination& examination : examinations) {
+            for (int number = 1; number <= Examination::FIELD_COUNT; ++number) {
+                examination.setFieldValue(number, QString::number(number - 1));
+            }
+        }
+        bytes = counter.bytes();
+    }
+    return bytes;
+}
+
+} // namespace
+
+/// Timings of the bulk loaders, the in-memory catalogs, the name search and the recipe totals,
+/// each beside the baseline it replaced, and the checks that both give the same results.
+/// The database is created in a temporary directory and filled with the same rows on every run,
+/// 100k recipes and 5000 clients with 20 examinations each by default:
+///     qmake && make && ./tst_benchmarks -median 5
+///     BENCHMARK_RECIPES=300 BENCHMARK_CLIENTS=20 BENCHMARK_EXAMINATIONS=25 ./tst_benchmarks     # a quick run
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void loadProducts();
+    void loadProductsPerRow();
+    void loadRecipes();
+    void loadRecipesPerRow();
+    void loadExaminationsOfClient();
+    void loadExaminationsOfClientPerRow();
+    void loadExaminationSummaries();
+    void readCachedProductsById();
+
+    void filterProductCatalog();
+    void filterProductsSql();
+    void filterRecipeCatalog();
+    void searchIndex();
+    void searchLinearScan();
+
+    void nutritionFacts_data();
+    void nutritionFacts();
+    void nutritionFactsMultiPass_data();
+    void nutritionFactsMultiPass();
+    void examinationFieldValues();
+    void examinationMemory_data();
+    void examinationMemory();
+    void copyRecipes();
+    void copyAllocations_data();
+    void copyAllocations();
+
+    void storedRecipeTotals();
+    void bulkProductsMatchRows();
+    void bulkRecipesMatchRows();
+    void bulkExaminationsMatchRows();
+    void productCatalogMatchesSql();
+    void searchIndexMatchesScan();
+    void nutritionFactsMatchMultiPass();
+
+private:
+    static constexpr int PRODUCT_COUNT = 2000;
+    static constexpr int RECIPE_COUNT = 100000;         // BENCHMARK_RECIPES
+    static constexpr int INGREDIENT_COUNT = 8;
+    static constexpr int CLIENT_COUNT = 5000;           // BENCHMARK_CLIENTS
+    static constexpr int EXAMINATION_COUNT = 20;        // of every client, BENCHMARK_EXAMINATIONS
+
+    int                             m_recipeCount = RECIPE_COUNT;
+    int                             m_clientCount = CLIENT_COUNT;
+    int                             m_examinationCount = EXAMINATION_COUNT;
+
+    QTemporaryDir                   m_dir;
+    QString                         m_oldCurrent;
+    std::unique_ptr<DatabaseModule> m_db;
+    QVector<ProductEntity>          m_products;
+    QVector<Client>                 m_clients;
+};
+
+void Benchmarks::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    m_oldCurrent = QDir::currentPath();
+    QDir::setCurrent(m_dir.path());         // the module opens ./database/db.sqlite
+    m_db.reset(new DatabaseModule);
+
+    /// Names of a few words, so the prefixes match many rows like a real catalog
+    const QStringList words = { "молоко", "сыр", "хлеб", "мясо", "рыба", "яблоко", "морковь", "овсянка" };
+    QVector<ProductEntity> products;
+    for (int i = 0; i < PRODUCT_COUNT; ++i) {
+        products << ProductEntity(0, QString("%1 %2 %3").arg(words[i % words.size()], words[i / words.size() % words.size()]).arg(i)
+                                  , QString("описание %1").arg(i)
+                                  , i % 30, i % 20, i % 70, i % 500, ProductEntity::GRAMM);
+    }
+    const QVector<unsigned> productIds = m_db->addProducts(products);
+    QCOMPARE(productIds.size(), PRODUCT_COUNT);
+    for (int i = 0; i < PRODUCT_COUNT; ++i) {
+        products[i].setId(int(productIds[i]));
+    }
+    m_products = products;
+
+    QVector<RecipeEntity> recipes;
+    m_recipeCount = countFromEnvironment("BENCHMARK_RECIPES", RECIPE_COUNT);
+    for (int i = 0; i < m_recipeCount; ++i) {
+        QVector<WeightedProduct> ingredients;
+        for (int j = 0; j < INGREDIENT_COUNT; ++j) {
+            ingredients << WeightedProduct(products[(i * INGREDIENT_COUNT + j) % PRODUCT_COUNT], 50 + j * 10);
+        }
+        recipes << RecipeEntity(0, QString("%1 с %2 %3").arg(words[i % words.size()], words[(i + 3) % words.size()]).arg(i)
+                                , ingredients, { "нарезать", "смешать", "запечь" });
+    }
+    QCOMPARE(m_db->addRecipes(recipes).size(), m_recipeCount);
+
+    m_clientCount = countFromEnvironment("BENCHMARK_CLIENTS", CLIENT_COUNT);
+    m_examinationCount = countFromEnvironment("BENCHMARK_EXAMINATIONS", EXAMINATION_COUNT);
+    for (int i = 0; i < m_clientCount; ++i) {
+        Client client(0, QString("Имя%1").arg(i), QString("Фамилия%1").arg(i), QString("Отчество%1").arg(i)
+                      , QDate(1950, 1, 1).addDays(i % 15000), i % 2 ? 'M' : 'F', short(20 + i % 50), "+70000000000");
+        QVERIFY(m_db->addClientAndSetID(client));
+        for (int j = 0; j < m_examinationCount; ++j) {
+            Examination examination;
+            examination.setClient(client);
+            examination.setIsFullExamination(j % 2 == 0);
+            examination.setDate(QDateTime(QDate(2020, 1, 1).addDays(j * 14), QTime(10, 0)));
+            for (int number = 1; number <= Examination::FIELD_COUNT; number += 3) {
+                examination.setFieldValue(number, QString::number(50 + j * 0.5));
+            }
+            QVERIFY(m_db->addExaminationAndSetID(examination));
+        }
+        m_clients << client;
+    }
+    QVERIFY(!m_db->hasUnwatchedWorkError());
+}
+
+void Benchmarks::cleanupTestCase()
+{
+    m_db.reset();
+    QDir::setCurrent(m_oldCurrent);
+}
+
+void Benchmarks::loadProducts()
+{
+    QVector<ProductEntity> products;
+    QBENCHMARK {
+        products = m_db->products();
+    }
+    QCOMPARE(products.size(), PRODUCT_COUNT);
+}
+
+void Benchmarks::loadProductsPerRow()
+{
+    QVector<ProductEntity> products;
+    QBENCHMARK {
+        products = baseline::products();
+    }
+    QCOMPARE(products.size(), PRODUCT_COUNT);
+}
+
+void Benchmarks::loadRecipes()
+{
+    QVector<RecipeEntity> recipes;
+    QBENCHMARK {
+        recipes = m_db->recipes();
+    }
+    QCOMPARE(recipes.size(), m_recipeCount);
+    QCOMPARE(recipes.first().products().size(), INGREDIENT_COUNT);
+}
+
+void Benchmarks::loadRecipesPerRow()
+{
+    QVector<RecipeEntity> recipes;
+    QBENCHMARK {
+        recipes = baseline::recipes();
+    }
+    QCOMPARE(recipes.size(), m_recipeCount);
+    QCOMPARE(recipes.first().products().size(), INGREDIENT_COUNT);
+}
+
+void Benchmarks::loadExaminationsOfClient()
+{
+    QVector<Examination> examinations;
+    QBENCHMARK {
+        examinations = m_db->examinations(m_clients.first());
+    }
+    QCOMPARE(examinations.size(), m_examinationCount);
+}
+
+void Benchmarks::loadExaminationsOfClientPerRow()
+{
+    QVector<Examination> examinations;
+    QBENCHMARK {
+        examinations = baseline::examinations(*m_db, m_clients.first());
+    }
+    QCOMPARE(examinations.size(), m_examinationCount);
+}
+
+void Benchmarks::loadExaminationSummaries()
+{
+    QVector<ExaminationSummary> summaries;
+    QBENCHMARK {
+        summaries = m_db->examinationSummaries();
+    }
+    QCOMPARE(summaries.size(), m_clientCount * m_examinationCount);
+}
+
+void Benchmarks::readCachedProductsById()
+{
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            m_db->product(unsigned(m_products[i].id()));
+        }
+    }
+    QVERIFY(m_db->entityCacheStats().hits > 0);
+}
+
+void Benchmarks::filterProductCatalog()
+{
+    ProductCatalog catalog;
+    QVERIFY(catalog.load(m_products, catalog.generation()));
+
+    ProductCatalog::Filter filter;
+    filter.proteins = { 5, 20 };
+    filter.kilocalories = { 100, 300 };
+    QVector<ProductEntity> products;
+    QBENCHMARK {
+        products = catalog.products(filter);
+    }
+    QVERIFY(!products.isEmpty());
+}
+
+void Benchmarks::filterProductsSql()
+{
+    QVector<int> ids;
+    QBENCHMARK {
+        ids = baseline::productIds("proteins", { 5, 20 });
+    }
+    QVERIFY(!ids.isEmpty());
+}
+
+void Benchmarks::filterRecipeCatalog()
+{
+    RecipeCatalog catalog;
+    QVERIFY(catalog.load(m_db->recipeSummaries(), catalog.generation()));
+
+    RecipeCatalog::Filter filter;
+    filter.basis = RecipeCatalog::Per100Grams;
+    filter.proteins = { 5, 25 };
+    QVector<RecipeSummary> recipes;
+    QBENCHMARK {
+        recipes = catalog.recipes(filter);
+    }
+    QVERIFY(!recipes.isEmpty());
+}
+
+void Benchmarks::searchIndex()
+{
+    SearchIndex index;
+    for (int i = 0; i < m_products.size(); ++i) {
+        index.add(i, m_products[i].name(), m_products[i].description());
+    }
+    index.build();
+
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString& prefix : TYPEAHEAD_PREFIXES) {
+            found += index.find(prefix, 50).size();
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void Benchmarks::searchLinearScan()
+{
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString& prefix : TYPEAHEAD_PREFIXES) {
+            found += qMin(50, baseline::find(m_products, prefix).size());
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void Benchmarks::nutritionFacts_data()
+{
+    QTest::addColumn<int>("ingredientCount");
+    for (int count : { 5, 20, 50, 200 }) {
+        QTest::newRow(qPrintable(QString("%1 ingredients").arg(count))) << count;
+    }
+}
+
+void Benchmarks::nutritionFacts()
+{
+    QFETCH(int, ingredientCount);
+    QVector<WeightedProduct> ingredients;
+    for (int i = 0; i < ingredientCount; ++i) {
+        ingredients << WeightedProduct(m_products[i + 1], 100 + i);
+    }
+    NutritionFacts portion;
+    NutritionFacts per100Grams;
+    QBENCHMARK {
+        portion = NutritionFacts::of(ingredients);
+        per100Grams = portion.per100Grams();
+    }
+    QVERIFY(portion.kilocalories > 0);
+    QCOMPARE(per100Grams.weight, 100.f);
+}
+
+void Benchmarks::nutritionFactsMultiPass_data()
+{
+    nutritionFacts_data();
+}
+
+void Benchmarks::nutritionFactsMultiPass()
+{
+    QFETCH(int, ingredientCount);
+    QVector<WeightedProduct> ingredients;
+    for (int i = 0; i < ingredientCount; ++i) {
+        ingredients << WeightedProduct(m_products[i + 1], 100 + i);
+    }
+    NutritionFacts portion;
+    QBENCHMARK {
+        portion = baseline::nutritionFacts(ingredients);
+    }
+    QVERIFY(portion.kilocalories > 0);
+}
+
+void Benchmarks::examinationFieldValues()
+{
+    const QVector<Examination> examinations = m_db->examinations(m_clients.first());
+    double sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        for (const Examination& examination : examinations) {
+            for (int number = 1; number <= Examination::FIELD_COUNT; ++number) {
+                bool isOk = false;
+                const double value = examination.realValue(number, &isOk);
+                sum += isOk ? value : 0;
+            }
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void Benchmarks::examinationMemory_data()
+{
+    QTest::addColumn<bool>("isFormFieldLayout");
+    QTest::newRow("90 FormFields each") << true;
+    QTest::newRow("values, shared schema") << false;
+}
+
+void Benchmarks::examinationMemory()
+{
+    if (!AllocationCounter::isAvailable()) {
+        QSKIP("The heap is counted on glibc only");
+    }
+    QFETCH(bool, isFormFieldLayout);
+    const int count = 1000;
+    const qint64 bytes = examinationBytes(count, isFormFieldLayout);
+    QTest::setBenchmarkResult(qreal(bytes) / count, QTest::BytesAllocated);     // per examination
+    QVERIFY(bytes > 0);
+    if (!isFormFieldLayout) {
+        QVERIFY(bytes < examinationBytes(count, true));
+    }
+}
+
+void Benchmarks::copyRecipes()
+{
+    const QVector<RecipeEntity> recipes = m_db->recipes();
+    float weight = 0;
+    QBENCHMARK {
+        QVector<RecipeEntity> copies;
+        copies.reserve(recipes.size());
+        for (const RecipeEntity& recipe : recipes) {
+            copies << recipe;
+        }
+        weight = copies.last().weight();
+    }
+    QVERIFY(weight > 0);
+}
+
+void Benchmarks::copyAllocations_data()
+{
+    QTest::addColumn<bool>("isRecipe");
+    QTest::addColumn<bool>("isShared");
+    QTest::newRow("products, shared") << false << true;
+    QTest::newRow("products, deep copies") << false << false;
+    QTest::newRow("recipes, shared") << true << true;
+    QTest::newRow("recipes, deep copies") << true << false;
+}
+
+void Benchmarks::copyAllocations()
+{
+    if (!AllocationCounter::isAvailable()) {
+        QSKIP("The heap is counted on glibc only");
+    }
+    QFETCH(bool, isRecipe);
+    QFETCH(bool, isShared);
+    const int count = 1000;
+    const QVector<ProductEntity> products = m_products.mid(0, count);
+    const QVector<RecipeEntity> recipes = isRecipe ? m_db->recipes().mid(0, count) : QVector<RecipeEntity>();
+
+    /// Into a vector reserved beforehand, so only the copies allocate
+    QVector<ProductEntity> productCopies;
+    QVector<RecipeEntity> recipeCopies;
+    productCopies.reserve(count);
+    recipeCopies.reserve(count);
+    AllocationCounter counter;
+    if (isRecipe) {
+        for (const RecipeEntity& recipe : recipes) {
+            recipeCopies << (isShared ? recipe : baseline::deepCopy(recipe));
+        }
+    } else {
+        for (const ProductEntity& product : products) {
+            productCopies << (isShared ? product : baseline::deepCopy(product));
+        }
+    }
+    const qint64 allocations = counter.allocations();
+    QTest::setBenchmarkResult(qreal(allocations) / count, QTest::Events);     // per entity
+    if (isShared) {
+        QCOMPARE(allocations, qint64(0));
+    } else {
+        QVERIFY(allocations > 0);
+    }
+}
+
+void Benchmarks::storedRecipeTotals()
+{
+    /// The totals kept by the triggers are the ones NutritionFacts computes from the ingredients
+    auto isClose = [](float stored, float computed) {
+        return qAbs(stored - computed) <= 0.01f * qMax(1.0f, qAbs(computed));
+    };
+    const QVector<RecipeEntity> recipes = m_db->recipes();
+    const QVector<RecipeSummary> summaries = m_db->recipeSummaries();
+    QCOMPARE(summaries.size(), recipes.size());
+    for (int i = 0; i < recipes.size(); ++i) {
+        const NutritionFacts facts = NutritionFacts::of(recipes[i].products());
+        QCOMPARE(summaries[i].id, recipes[i].id());
+        QVERIFY(isClose(summaries[i].proteins, facts.proteins));
+        QVERIFY(isClose(summaries[i].fats, facts.fats));
+        QVERIFY(isClose(summaries[i].carbohydrates, facts.carbohydrates));
+        QVERIFY(isClose(summaries[i].kcal, facts.kilocalories));
+        QVERIFY(isClose(summaries[i].weight, facts.weight));
+    }
+}
+
+void Benchmarks::bulkProductsMatchRows()
+{
+    const QVector<ProductEntity> products = m_db->products();
+    const QVector<ProductEntity> rows = baseline::products();
+    QCOMPARE(products.size(), rows.size());
+    for (int i = 0; i < products.size(); ++i) {
+        QCOMPARE(products[i].id(), rows[i].id());
+        QCOMPARE(products[i].name(), rows[i].name());
+        QCOMPARE(products[i].description(), rows[i].description());
+        QCOMPARE(products[i].proteins(), rows[i].proteins());
+        QCOMPARE(products[i].fats(), rows[i].fats());
+        QCOMPARE(products[i].carbohydrates(), rows[i].carbohydrates());
+        QCOMPARE(products[i].kilocalories(), rows[i].kilocalories());
+        QCOMPARE(products[i].units(), rows[i].units());
+    }
+}
+
+void Benchmarks::bulkRecipesMatchRows()
+{
+    const QVector<RecipeEntity> recipes = m_db->recipes();
+    const QVector<RecipeEntity> rows = baseline::recipes();
+    QCOMPARE(recipes.size(), rows.size());
+    for (int i = 0; i < recipes.size(); ++i) {
+        QCOMPARE(recipes[i].id(), rows[i].id());
+        QCOMPARE(recipes[i].name(), rows[i].name());
+        QCOMPARE(ingredientIds(recipes[i]), ingredientIds(rows[i]));
+        QCOMPARE(recipes[i].cookingPoints(), rows[i].cookingPoints());
+    }
+}
+
+void Benchmarks::bulkExaminationsMatchRows()
+{
+    for (const Client& client : m_clients.mid(0, 3)) {
+        const QVector<Examination> examinations = m_db->examinations(client);
+        const QVector<Examination> rows = baseline::examinations(*m_db, client);
+        QCOMPARE(examinations.size(), rows.size());
+        for (int i = 0; i < examinations.size(); ++i) {
+            QCOMPARE(examinations[i].id(), rows[i].id());
+            QCOMPARE(examinations[i].client().id(), rows[i].client().id());
+            QCOMPARE(examinations[i].isFullExamination(), rows[i].isFullExamination());
+            QCOMPARE(examinations[i].date(), rows[i].date());
+            for (int number = 1; number <= Examination::FIELD_COUNT; ++number) {
+                QCOMPARE(examinations[i].value(number), rows[i].value(number));
+            }
+        }
+    }
+}
+
+void Benchmarks::productCatalogMatchesSql()
+{
+    ProductCatalog catalog;
+    QVERIFY(catalog.load(m_db->products(), catalog.generation()));
+
+    ProductCatalog::Filter filter;
+    filter.proteins = { 5, 20 };
+    QVector<int> ids;
+    for (const ProductEntity& product : catalog.products(filter)) {
+        ids << product.id();
+    }
+    QCOMPARE(ids, baseline::productIds("proteins", { 5, 20 }));
+}
+
+void Benchmarks::searchIndexMatchesScan()
+{
+    SearchIndex index;
+    for (int i = 0; i < m_products.size(); ++i) {
+        index.add(i, m_products[i].name(), m_products[i].description());
+    }
+    index.build();
+
+    for (const QString& prefix : TYPEAHEAD_PREFIXES + QStringList{ "описание 1", "сыр хлеб" }) {
+        QVector<int> rows = index.find(prefix);
+        std::sort(rows.begin(), rows.end());
+        QCOMPARE(rows, baseline::find(m_products, prefix));
+    }
+}
+
+void Benchmarks::nutritionFactsMatchMultiPass()
+{
+    for (const RecipeEntity& recipe : m_db->recipes().mid(0, 50)) {
+        const NutritionFacts facts = NutritionFacts::of(recipe.products());
+        const NutritionFacts passes = baseline::nutritionFacts(recipe.products());
+        QVERIFY(qFuzzyCompare(facts.proteins + 1, passes.proteins + 1));
+        QVERIFY(qFuzzyCompare(facts.fats + 1, passes.fats + 1));
+        QVERIFY(qFuzzyCompare(facts.carbohydrates + 1, passes.carbohydrates + 1));
+        QVERIFY(qFuzzyCompare(facts.kilocalories + 1, passes.kilocalories + 1));
+        QCOMPARE(facts.weight, passes.weight);
+    }
+}
+
+QTEST_GUILESS_MAIN(Benchmarks)
+
+#include "tst_benchmarks.moc"
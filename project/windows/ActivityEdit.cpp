@@ -23,6 +23,7 @@ void ActivityEdit::setInformation(const ActivityEntity &a)
     _isEditingMod = true;
 
     _activity.setId(a.id());
+    _activity.setVersion(a.version());
 
     ui->lineEdit_activityName->setText(a.type());
     ui->lineEdit_calories->setText(QLocale::system().toString(a.kkm()));
@@ -48,7 +49,9 @@ void ActivityEdit::onPushButtonSave()
     QString activityName = ui->lineEdit_activityName->text();
     float kkm = QLocale::system().toDouble(ui->lineEdit_calories->text());
 
+    const int version = _activity.version();
     _activity = ActivityEntity(_activity.id(), activityName, kkm);
+    _activity.setVersion(version);
 
     if (_isEditingMod) {
         emit formEditedActivityReady();
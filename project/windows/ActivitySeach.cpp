@@ -1,5 +1,6 @@
 #include "ActivitySeach.h"
 #include "ui_Activity_seach.h"
+#include <QHeaderView>
 #include <QDebug>
 
 ActivitySeach::ActivitySeach(QWidget *parent) :
@@ -8,11 +9,24 @@ ActivitySeach::ActivitySeach(QWidget *parent) :
 {
     ui->setupUi(this);
 
+    m_model = new PagedTableModel<ActivityEntity>(
+                { tr("Активность"), tr("Ккал/кг/мин") },
+                [](const ActivityEntity& activity, int column) -> QVariant {
+                    switch (column) {
+                    case 0: return activity.type();
+                    case 1: return QLocale::system().toString(activity.kkm());
+                    }
+                    return QVariant();
+                },
+                [](const ActivityEntity& activity) { return activity.id(); },
+                this);
+    ui->tableView_activitys->setModel(m_model);
+
     connect(ui->pushButton_search, SIGNAL(pressed()), SLOT(onPushButtonSeach()));
     connect(ui->pushButton_searchAll, SIGNAL(pressed()), SIGNAL(requireUpdateAllInform()));
     connect(ui->radioButton_activitySearch, SIGNAL(pressed()), SLOT(onActivitySeachType()));
     connect(ui->radioButton_kcalSearch, SIGNAL(pressed()), SLOT(onKcalSeachType()));
-    connect(ui->tableWidget_activitys, SIGNAL(pressed(QModelIndex)), SLOT(onSelectActivity(QModelIndex)));
+    connect(ui->tableView_activitys, SIGNAL(pressed(QModelIndex)), SLOT(onSelectActivity(QModelIndex)));
 }
 
 ActivityEntity ActivitySeach::selectedActivity() const
@@ -22,17 +36,17 @@ ActivityEntity ActivitySeach::selectedActivity() const
 
 void ActivitySeach::setInformation(const QVector<ActivityEntity> &activitys)
 {
-    _activitys = activitys;
-
-    ui->tableWidget_activitys->setRowCount(_activitys.size());
+    m_model->setRows(activitys);
+}
 
-    for (int iRow = 0; iRow < _activitys.size(); ++iRow)
-    {
-        ui->tableWidget_activitys->setItem(iRow, 0, new QTableWidgetItem(_activitys[iRow].type()));
-        ui->tableWidget_activitys->setItem(iRow, 1, new QTableWidgetItem(QLocale::system().toString(_activitys[iRow].kkm())));
-    }
+void ActivitySeach::setInformationSource(PagedTableModel<ActivityEntity>::Source source, PagedTableModel<ActivityEntity>::OnFirstPage onFirstPage)
+{
+    m_model->setSource(source, onFirstPage);
+}
 
-    this->repaint();
+bool ActivitySeach::isEmpty() const
+{
+    return m_model->isEmpty();
 }
 
 void ActivitySeach::onPushButtonSeach()
@@ -61,12 +75,12 @@ void ActivitySeach::onKcalSeachType()
 
 void ActivitySeach::onSelectActivity(const QModelIndex &index)
 {
-    int selectedActivity = index.row();
-    if (selectedActivity >= _activitys.size() && selectedActivity < 0) {
+    if (!index.isValid() || index.row() >= m_model->rowCount()) {
         qDebug() << "Error: ActivitySeach::onSelectActivity(const QModelIndex &index)"
                  << "Not correct client vector index";
+        return;
     }
-    _selectedActivity = _activitys[selectedActivity];
+    _selectedActivity = m_model->row(index.row());
     emit selectedForShow();
 }
 
@@ -77,53 +91,20 @@ ActivitySeach::~ActivitySeach()
 
 void ActivitySeach::paintEvent(QPaintEvent *event)
 {
-    auto width = ui->tableWidget_activitys->width();
-    ui->tableWidget_activitys->horizontalHeader()->setStretchLastSection(true);
-    ui->tableWidget_activitys->setColumnWidth(0, width * 3/4-13);
-    ui->tableWidget_activitys->setColumnWidth(1, width * 1/4-13);
+    auto width = ui->tableView_activitys->width();
+    ui->tableView_activitys->horizontalHeader()->setStretchLastSection(true);
+    ui->tableView_activitys->setColumnWidth(0, width * 3/4-13);
+    ui->tableView_activitys->setColumnWidth(1, width * 1/4-13);
 
     QWidget::paintEvent(event);
 }
 
 void ActivitySeach::hideInformationIfExists(ActivityEntity &activity)
 {
-    for(const auto &act : _activitys){
-        if (act.id() == activity.id()){
-            for(int i = 0; ui->tableWidget_activitys->rowCount(); ++i){
-                if (act.type() == ui->tableWidget_activitys->item(i, 0)->text()){
-                    ui->tableWidget_activitys->removeRow(i);
-                    for(int j = 0; j < _activitys.size(); ++j){
-                        if(_activitys[j].type() == activity.type()){
-                            qDebug() << "ok";
-                            _activitys.erase(_activitys.begin()+j);
-                        }
-                    }
-                    return;
-                }
-            }
-        }
-    }
-    this->repaint();
+    m_model->removeRowById(activity.id());
 }
 
 void ActivitySeach::updateInformationIfExist(ActivityEntity &activity)
 {
-    qDebug() << "ok";
-    for(const auto &act : _activitys){
-        if (act.id() == activity.id()){
-            for(int i = 0; ui->tableWidget_activitys->rowCount(); ++i){
-                if (act.type() == ui->tableWidget_activitys->item(i, 0)->text()){
-                    ui->tableWidget_activitys->item(i, 0)->setText(activity.type());
-                    ui->tableWidget_activitys->item(i, 1)->setText(QLocale::system().toString(activity.kkm()));
-                    for(int j = 0; j < _activitys.size(); ++j){
-                        if(_activitys[j].type() == activity.type()){
-                           _activitys[j] = activity;
-                        }
-                    }
-                    return;
-                }
-            }
-        }
-    }
-    this->repaint();
+    m_model->updateRowById(activity);
 }
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include "entities/activity.h"
+#include "PagedTableModel.h"
 
 namespace Ui {
 class ActivitySeach;
@@ -21,6 +22,8 @@ public:
     void hideInformationIfExists(ActivityEntity & );
     void updateInformationIfExist(ActivityEntity & );
     void setInformation(const QVector<ActivityEntity>& );
+    void setInformationSource(PagedTableModel<ActivityEntity>::Source source, PagedTableModel<ActivityEntity>::OnFirstPage onFirstPage = nullptr);  // loaded page by page while scrolling
+    bool isEmpty() const;
     ActivityEntity selectedActivity() const;
 
 signals:
@@ -37,7 +40,7 @@ private slots:
 
 private:
     Ui::ActivitySeach *ui;
-    QVector<ActivityEntity> _activitys;
+    PagedTableModel<ActivityEntity> *m_model;
     ActivityEntity _selectedActivity;
 };
 
@@ -24,6 +24,7 @@ void ClientEdit::setInformation(const Client &c)
     _isEditingMod = true;
 
     _client.setId(c.id());
+    _client.setVersion(c.version());
 
     _ui.lineEdit_name->setText(c.name());
     _ui.lineEdit_surname->setText(c.surname());
@@ -72,7 +73,9 @@ void ClientEdit::onPushButtonSave()
     QString telNumber = _ui.lineEdit_telNumber->text();
     short age = QDate::currentDate().year() - birthday.year();
 
+    const int version = _client.version();
     _client = Client(_client.id(), name, surname, patronymic, birthday, gender, age, telNumber);
+    _client.setVersion(version);
 
     if (_isEditingMod) {
         emit formEditedClientReady();
@@ -1,5 +1,7 @@
 #include "ClientInfo.h"
 
+#include <QLocale>
+
 ClientInfo::ClientInfo(QWidget *wgt)
     : QWidget(wgt)
 {
@@ -12,7 +14,8 @@ ClientInfo::ClientInfo(QWidget *wgt)
     connect(_ui.tableWidget_examinations, SIGNAL(pressed(QModelIndex)), SLOT(onSelectExamination(QModelIndex)));
 }
 
-void ClientInfo::setInformation(const Client &client, const QVector<Examination> &examinations)
+void ClientInfo::setInformation(const Client &client, const QVector<Examination> &examinations,
+                                const ExaminationTrends &trends)
 {
     _client = client;
     _examinations = examinations;
@@ -33,10 +36,40 @@ void ClientInfo::setInformation(const Client &client, const QVector<Examination>
         _ui.tableWidget_examinations->setItem(iRow, 0, new QTableWidgetItem(columnStr1));
         _ui.tableWidget_examinations->setItem(iRow, 1, new QTableWidgetItem(columnStr2));
     }
+    showTrends(trends);
 
     this->repaint();
 }
 
+void ClientInfo::showTrends(const ExaminationTrends &trends)
+{
+    const QString titles[ExaminationTrends::MEASURE_COUNT] = {
+        tr("Масса тела"), tr("Окружность талии"), tr("Окружность бедер"),
+        tr("Индекс массы тела"), tr("Глюкоза"), tr("Холестерин")
+    };
+
+    auto change = [](double value) {
+        return (value > 0 ? "+" : "") + QLocale::system().toString(value);
+    };
+
+    _ui.tableWidget_trends->setRowCount(0);
+    for (int i = 0; i < ExaminationTrends::MEASURE_COUNT; ++i) {
+        const auto measure = ExaminationTrends::Measure(i);
+        const ExaminationTrends::Series& points = trends.series(measure);
+        if (points.isEmpty()) {
+            continue;
+        }
+        int iRow = _ui.tableWidget_trends->rowCount();
+        _ui.tableWidget_trends->insertRow(iRow);
+        _ui.tableWidget_trends->setItem(iRow, 0, new QTableWidgetItem(titles[i]));
+        _ui.tableWidget_trends->setItem(iRow, 1, new QTableWidgetItem(QLocale::system().toString(points.first().value)));
+        _ui.tableWidget_trends->setItem(iRow, 2, new QTableWidgetItem(QLocale::system().toString(points.last().value)));
+        _ui.tableWidget_trends->setItem(iRow, 3, new QTableWidgetItem(change(trends.delta(measure))));
+        _ui.tableWidget_trends->setItem(iRow, 4, new QTableWidgetItem(change(trends.lastChange(measure))));
+    }
+    _ui.tableWidget_trends->setVisible(!trends.isEmpty());
+}
+
 void ClientInfo::onSelectExamination(const QModelIndex &index)
 {
     int selectedExam = index.row();
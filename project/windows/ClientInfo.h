@@ -1,12 +1,14 @@
 #include "ui_Client_info.h"
 #include "entities/examination.h"
 #include "entities/client.h"
+#include "examinationtrends.h"
 
 class ClientInfo : public QWidget {
     Q_OBJECT
 public:
     ClientInfo(QWidget* wgt = 0);
-    void setInformation(const Client &client, const QVector<Examination> &examinations);
+    void setInformation(const Client &client, const QVector<Examination> &examinations,
+                        const ExaminationTrends &trends = ExaminationTrends());
     Client client() const;
     Examination selectedExamination() const;
 
@@ -23,6 +25,8 @@ private slots:
     void onSelectExamination(const QModelIndex& );
 
 private:
+    void showTrends(const ExaminationTrends &trends);
+
     Ui::form_clientInfo _ui;
     Client _client;
     QVector<Examination> _examinations;
@@ -1,4 +1,5 @@
 #include "ClientSeach.h"
+#include <QHeaderView>
 #include <QDebug>
 
 ClientSearch::ClientSearch(QWidget *wgt)
@@ -6,76 +7,67 @@ ClientSearch::ClientSearch(QWidget *wgt)
 {
     _ui.setupUi(this);
 
+    m_model = new PagedTableModel<ClientSummary>(
+                { tr("Фамилия"), tr("Имя"), tr("Отчество") },
+                [](const ClientSummary& client, int column) -> QVariant {
+                    switch (column) {
+                    case 0: return client.surname;
+                    case 1: return client.name;
+                    case 2: return client.patronymic;
+                    }
+                    return QVariant();
+                },
+                [](const ClientSummary& client) { return client.id; },
+                this);
+    _ui.tableView_clients->setModel(m_model);
+
     connect(_ui.pushButton_seach, SIGNAL(pressed()), SLOT(onPushButtonSeach()));
     connect(_ui.pushButton_searchAll, SIGNAL(pressed()), SIGNAL(requireUpdateAllInform()));
-    connect(_ui.tableWidget_clients, SIGNAL(pressed(QModelIndex)), SLOT(onSelectClient(QModelIndex)));
+    connect(_ui.tableView_clients, SIGNAL(pressed(QModelIndex)), SLOT(onSelectClient(QModelIndex)));
 }
 
-void ClientSearch::setInformation(const QVector<Client> &clients)
+void ClientSearch::setInformation(const QVector<ClientSummary> &clients)
 {
-    _clients = clients;
-
-    _ui.tableWidget_clients->setRowCount(_clients.size());
+    m_model->setRows(clients);
+}
 
-    for(int iRow = 0; iRow < _clients.size(); ++iRow) {
-        QStringList strColumns;
-        strColumns << _clients[iRow].surname();
-        strColumns << _clients[iRow].name();
-        strColumns << _clients[iRow].patronymic();
+void ClientSearch::setInformationSource(PagedTableModel<ClientSummary>::Source source, PagedTableModel<ClientSummary>::OnFirstPage onFirstPage)
+{
+    m_model->setSource(source, onFirstPage);
+}
 
-        for(int iCol = 0; iCol < strColumns.size(); ++iCol) {
-            _ui.tableWidget_clients->setItem(iRow, iCol, new QTableWidgetItem(strColumns[iCol]));
-        }
-    }
-    this->repaint();
+bool ClientSearch::isEmpty() const
+{
+    return m_model->isEmpty();
 }
 
-Client ClientSearch::selectedClient() const
+ClientSummary ClientSearch::selectedClient() const
 {
     return _selectedClient;
 }
 
 void ClientSearch::hideInformationIfExists(const Client &client)
 {
-    for(const auto &tmp : _clients){
-        if (tmp.id() == client.id()){
-            for(int i = 0; _ui.tableWidget_clients->rowCount(); ++i){
-                if (tmp.surname()    == _ui.tableWidget_clients->item(i, 0)->text() &&
-                    tmp.name()       == _ui.tableWidget_clients->item(i, 1)->text() &&
-                    tmp.patronymic() == _ui.tableWidget_clients->item(i, 2)->text()){
-                    _ui.tableWidget_clients->removeRow(i);
-                    return;
-                }
-            }
-        }
-    }
+    m_model->removeRowById(client.id());
 }
 
 void ClientSearch::updateInformationIfExist(Client &client)
 {
-    for(const auto &tmp : _clients){
-        if (tmp.id() == client.id()){
-            for(int i = 0; _ui.tableWidget_clients->rowCount(); ++i){
-                if (tmp.surname()    == _ui.tableWidget_clients->item(i, 0)->text() &&
-                    tmp.name()       == _ui.tableWidget_clients->item(i, 1)->text() &&
-                    tmp.patronymic() == _ui.tableWidget_clients->item(i, 2)->text()){
-                    _ui.tableWidget_clients->item(i, 0)->setText(client.surname());
-                    _ui.tableWidget_clients->item(i, 1)->setText(client.name());
-                    _ui.tableWidget_clients->item(i, 2)->setText(client.patronymic());
-                    return;
-                }
-            }
-        }
-    }
+    ClientSummary summary;
+    summary.id = client.id();
+    summary.surname = client.surname();
+    summary.name = client.name();
+    summary.patronymic = client.patronymic();
+    m_model->updateRowById(summary);
 }
 
 void ClientSearch::paintEvent(QPaintEvent *event)
 {
-    auto width = _ui.tableWidget_clients->width();
-    _ui.tableWidget_clients->horizontalHeader()->setStretchLastSection(true);
-    _ui.tableWidget_clients->setColumnWidth(0, width / 3 - 10);
-    _ui.tableWidget_clients->setColumnWidth(1, width / 3 - 10);
-    _ui.tableWidget_clients->setColumnWidth(2, width / 3 - 10);
+    auto width = _ui.tableView_clients->width();
+    _ui.tableView_clients->horizontalHeader()->setStretchLastSection(true);
+    _ui.tableView_clients->setColumnWidth(0, width / 3 - 10);
+    _ui.tableView_clients->setColumnWidth(1, width / 3 - 10);
+    _ui.tableView_clients->setColumnWidth(2, width / 3 - 10);
 
     QWidget::paintEvent(event);
 }
@@ -88,11 +80,11 @@ void ClientSearch::onPushButtonSeach()
 
 void ClientSearch::onSelectClient(const QModelIndex &index)
 {
-    int selectedClient = index.row();
-    if (selectedClient >= _clients.size() && selectedClient < 0){
+    if (!index.isValid() || index.row() >= m_model->rowCount()){
         qDebug() << "Error: ClientSearch::onSelectClient(const QModelIndex &)"
                  << "Not correct client vector index";
+        return;
     }
-    _selectedClient = _clients[selectedClient];
+    _selectedClient = m_model->row(index.row());
     emit selectedForShow();
 }
@@ -1,13 +1,17 @@
 #include "ui_Client_search.h"
 #include "entities/client.h"
+#include "entities/summaries.h"
+#include "PagedTableModel.h"
 
 class ClientSearch : public QWidget {
     Q_OBJECT
 public:
     ClientSearch(QWidget* wgt = 0);
 
-    void setInformation(const QVector<Client>& );
-    Client selectedClient() const;
+    void setInformation(const QVector<ClientSummary>& );
+    void setInformationSource(PagedTableModel<ClientSummary>::Source source, PagedTableModel<ClientSummary>::OnFirstPage onFirstPage = nullptr);  // loaded page by page while scrolling
+    bool isEmpty() const;
+    ClientSummary selectedClient() const;
     void hideInformationIfExists(const Client &activity);
     void updateInformationIfExist(Client & );
 
@@ -24,6 +28,6 @@ private slots:
 
 private:
     Ui::form_clientsSearch _ui;
-    QVector<Client> _clients;
-    Client _selectedClient;
+    PagedTableModel<ClientSummary> *m_model;
+    ClientSummary _selectedClient;
 };
@@ -45,7 +45,7 @@ void ExaminationEdit::setInformation(const Client &client, bool isFullExaminatio
     _ui.label_examination_type->setText(examinationType);
 
     if (!isFullExamination) {
-        foreach (FormField field, _examination.fields()) {
+        foreach (FormField field, Examination::schema()) {
             QWidget* widgetField = this->findChild<QWidget*>(field.name());
             if (field.isMayBeEmpty()) {
                 widgetField->setEnabled(false);
@@ -106,7 +106,7 @@ void ExaminationEdit::setInformation(const Examination& examination)
             ((QTextEdit*)widgetField)->setText(field.value());
         } break;
         case FormField::Date : {
-            ((QDateEdit*)widgetField)->setDate(QDate::fromString(field.value(), "ddMMyyyy"));
+            ((QDateEdit*)widgetField)->setDate(Examination::toDate(field.value()));
         } break;
         case FormField::Float :
         case FormField::UShort : {
@@ -145,7 +145,7 @@ void ExaminationEdit::onNextPage()
     bool isOpenErrDialog = false;
 
 
-    foreach (FormField field, _examination.fields()) {
+    foreach (FormField field, Examination::schema()) {
         bool isBlankField = false;
 
        QWidget* widgetField = scrollAreaWidgetContents->findChild<QWidget*>(field.name());
@@ -207,7 +207,7 @@ void ExaminationEdit::onSaveForm()
     QString errStyle = "QWidget { background: rgb(255, 179, 179); }";
     bool isOpenErrDialog = false;
 
-    foreach (FormField field, _examination.fields()) {
+    foreach (FormField field, Examination::schema()) {
         bool isBlankField = false;
 
         QWidget* widgetField = this->findChild<QWidget*>(field.name());
@@ -262,7 +262,7 @@ void ExaminationEdit::onSaveForm()
 
     /// Reading form values
     ///
-    foreach (FormField field, _examination.fields()) {
+    foreach (FormField field, Examination::schema()) {
         QWidget* widgetField = this->findChild<QWidget*>(field.name());
         QString fieldValue;
 
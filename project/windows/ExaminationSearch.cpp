@@ -1,95 +1,85 @@
 #include "ExaminationSearch.h"
+#include <QHeaderView>
 #include <QDebug>
+
 ExaminationSearch::ExaminationSearch(QWidget *wgt)
     :QWidget(wgt)
 {
     _ui.setupUi(this);
 
+    m_model = new PagedTableModel<ExaminationSummary>(
+                { tr("Дата"), tr("Время"), tr("Клиент"), tr("Тип") },
+                [](const ExaminationSummary& examination, int column) -> QVariant {
+                    switch (column) {
+                    case 0: return examination.date.date().toString();
+                    case 1: return examination.date.time().toString();
+                    case 2: return QString("%1 %2. %3.")
+                                .arg(examination.client.surname)
+                                .arg(examination.client.name.left(1))
+                                .arg(examination.client.patronymic.left(1));
+                    case 3: return examination.isFullExamination ? tr("Прием") : tr("Консультация");
+                    }
+                    return QVariant();
+                },
+                [](const ExaminationSummary& examination) { return examination.id; },
+                this);
+    _ui.tableView_examinations->setModel(m_model);
+
     connect(_ui.pushButton_seach, SIGNAL(pressed()), SLOT(onPushButtonSeach()));
     connect(_ui.pushButton_searchAll, SIGNAL(pressed()), SIGNAL(requireUpdateAllInform()));
     connect(_ui.radioButton_clientSeach, SIGNAL(pressed()), SLOT(onClientSeachType()));
     connect(_ui.radioButton_dateSeach, SIGNAL(pressed()), SLOT(onDateSeachType()));
-    connect(_ui.tableWidget_examinations, SIGNAL(pressed(QModelIndex)), SLOT(onSelectExamination(QModelIndex)));
+    connect(_ui.tableView_examinations, SIGNAL(pressed(QModelIndex)), SLOT(onSelectExamination(QModelIndex)));
 }
 
-Examination ExaminationSearch::selectedExamination() const
+ExaminationSummary ExaminationSearch::selectedExamination() const
 {
     return _selectedExamination;
 }
 
 void ExaminationSearch::hideInformationIfExists(const Examination &examination)
 {
-    for(const auto &tmp : _examinations){
-        if (tmp.id() == examination.id()){
-            for(int i = 0; _ui.tableWidget_examinations->rowCount(); ++i){
-                if (tmp.date().date().toString() == _ui.tableWidget_examinations->item(i, 0)->text() &&
-                    tmp.date().time().toString() == _ui.tableWidget_examinations->item(i, 1)->text()){
-                    _ui.tableWidget_examinations->removeRow(i);
-                    return;
-                }
-            }
-        }
-    }
+    m_model->removeRowById(examination.id());
 }
 
 void ExaminationSearch::updateInformationIfExist(Examination &examinaton)
 {
-    for(const auto &tmp : _examinations){
-        if (tmp.id() == examinaton.id()){
-            for(int i = 0; _ui.tableWidget_examinations->rowCount(); ++i){
-                if (tmp.date().date().toString() == _ui.tableWidget_examinations->item(i, 0)->text() &&
-                    tmp.date().time().toString() == _ui.tableWidget_examinations->item(i, 1)->text()){
-                    QString name = QString("%1 %2. %3.")
-                            .arg(examinaton.client().surname())
-                            .arg(examinaton.client().name()[0])
-                            .arg(examinaton.client().patronymic()[0]);
-                    _ui.tableWidget_examinations->item(i, 0)->setText(examinaton.date().date().toString());
-                    _ui.tableWidget_examinations->item(i, 1)->setText(examinaton.date().time().toString());
-                    _ui.tableWidget_examinations->item(i, 2)->setText(name);
-                    _ui.tableWidget_examinations->item(i, 3)->setText(examinaton.isFullExamination() ? tr("Прием") : tr("Консультация"));
-                    return;
-                }
-            }
-        }
-    }
+    ExaminationSummary summary;
+    summary.id = examinaton.id();
+    summary.client.id = examinaton.client().id();
+    summary.client.surname = examinaton.client().surname();
+    summary.client.name = examinaton.client().name();
+    summary.client.patronymic = examinaton.client().patronymic();
+    summary.isFullExamination = examinaton.isFullExamination();
+    summary.date = examinaton.date();
+    m_model->updateRowById(summary);
 }
 
 void ExaminationSearch::paintEvent(QPaintEvent *event)
 {
-    auto width = _ui.tableWidget_examinations->width();
-    _ui.tableWidget_examinations->horizontalHeader()->setStretchLastSection(true);
-    _ui.tableWidget_examinations->setColumnWidth(0, width * 3/12-10);
-    _ui.tableWidget_examinations->setColumnWidth(1, width * 2/12-10);
-    _ui.tableWidget_examinations->setColumnWidth(2, width * 5/12-10);
-    _ui.tableWidget_examinations->setColumnWidth(3, width * 2/12-10);
+    auto width = _ui.tableView_examinations->width();
+    _ui.tableView_examinations->horizontalHeader()->setStretchLastSection(true);
+    _ui.tableView_examinations->setColumnWidth(0, width * 3/12-10);
+    _ui.tableView_examinations->setColumnWidth(1, width * 2/12-10);
+    _ui.tableView_examinations->setColumnWidth(2, width * 5/12-10);
+    _ui.tableView_examinations->setColumnWidth(3, width * 2/12-10);
 
     QWidget::paintEvent(event);
 }
 
-void ExaminationSearch::setInformation(const QVector<Examination> &exms)
+void ExaminationSearch::setInformation(const QVector<ExaminationSummary> &exms)
 {
-    _examinations = exms;
-
-    _ui.tableWidget_examinations->setRowCount(_examinations.size());
-
-    for(int iRow = 0; iRow < _examinations.size(); ++iRow) {
-        QString name = QString("%1 %2. %3.")
-                .arg(_examinations[iRow].client().surname())
-                .arg(_examinations[iRow].client().name()[0])
-                .arg(_examinations[iRow].client().patronymic()[0]);
-
-        QStringList strColumns;
-        strColumns << _examinations[iRow].date().date().toString()
-                   << _examinations[iRow].date().time().toString()
-                   << name
-                   << (_examinations[iRow].isFullExamination() ? tr("Прием") : tr("Консультация"));
+    m_model->setRows(exms);
+}
 
-        for(int iCol = 0; iCol < strColumns.size(); ++iCol) {
-            _ui.tableWidget_examinations->setItem(iRow, iCol, new QTableWidgetItem(strColumns[iCol]));
-        }
-    }
+void ExaminationSearch::setInformationSource(PagedTableModel<ExaminationSummary>::Source source, PagedTableModel<ExaminationSummary>::OnFirstPage onFirstPage)
+{
+    m_model->setSource(source, onFirstPage);
+}
 
-    this->repaint();
+bool ExaminationSearch::isEmpty() const
+{
+    return m_model->isEmpty();
 }
 
 void ExaminationSearch::onPushButtonSeach()
@@ -118,11 +108,11 @@ void ExaminationSearch::onClientSeachType()
 
 void ExaminationSearch::onSelectExamination(const QModelIndex &index)
 {
-    int selectedExm = index.row();
-    if (selectedExm >= _examinations.size() && selectedExm < 0){
+    if (!index.isValid() || index.row() >= m_model->rowCount()){
         qDebug() << "Error: ClientSearch::onSelectClient(const QModelIndex &)"
                  << "Not correct client vector index";
+        return;
     }
-    _selectedExamination = _examinations[selectedExm];
+    _selectedExamination = m_model->row(index.row());
     emit selectedForShow();
 }
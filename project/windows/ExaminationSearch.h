@@ -1,13 +1,17 @@
 #include "ui_Examination_search.h"
 #include "entities/examination.h"
+#include "entities/summaries.h"
+#include "PagedTableModel.h"
 
 class ExaminationSearch : public QWidget {
     Q_OBJECT
 public:
     ExaminationSearch(QWidget* wgt = 0);
 
-    void setInformation(const QVector<Examination>& );
-    Examination selectedExamination() const;
+    void setInformation(const QVector<ExaminationSummary>& );
+    void setInformationSource(PagedTableModel<ExaminationSummary>::Source source, PagedTableModel<ExaminationSummary>::OnFirstPage onFirstPage = nullptr);  // loaded page by page while scrolling
+    bool isEmpty() const;
+    ExaminationSummary selectedExamination() const;
     void hideInformationIfExists(const Examination &examination);
     void updateInformationIfExist(Examination & );
 
@@ -27,6 +31,6 @@ private slots:
 
 private:
     Ui::form_examinationSeach _ui;
-    QVector<Examination> _examinations;
-    Examination _selectedExamination;
+    PagedTableModel<ExaminationSummary> *m_model;
+    ExaminationSummary _selectedExamination;
 };
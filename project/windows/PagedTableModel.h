@@ -0,0 +1,171 @@
+#ifndef PAGEDTABLEMODEL_H
+#define PAGEDTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QVector>
+#include <QDebug>
+#include <functional>
+
+#include "databasereply.h"
+
+/// Table model of the search windows. Rows are asked from the source page by page
+/// while the view scrolls (canFetchMore/fetchMore), so only the shown rows are loaded.
+/// A page arrives asynchronously, the GUI thread does not wait for it.
+template<typename Row>
+class PagedTableModel : public QAbstractTableModel
+{
+public:
+    using Source = std::function<QFuture<DatabaseReply<QVector<Row>>>(int afterId, int limit)>;    // rows with id > afterId in the id order
+    using OnFirstPage = std::function<void(const QStringList& errors)>;                 // the errors of the first page
+    using Cell   = std::function<QVariant(const Row&, int column)>;
+    using RowId  = std::function<int(const Row&)>;
+
+    static constexpr int PAGE_SIZE = 200;
+
+    PagedTableModel(const QStringList& headers, Cell cell, RowId rowId, QObject *parent = nullptr)
+        : QAbstractTableModel(parent), m_headers(headers), m_cell(cell), m_rowId(rowId)
+    {
+    }
+
+    /// All the rows at once, for the lists already in memory
+    void setRows(const QVector<Row>& rows)
+    {
+        cancelFetch();
+        beginResetModel();
+        m_source = Source();
+        m_rows = rows;
+        m_isExhausted = true;
+        endResetModel();
+    }
+
+    /// Drops the rows and requests the first page from the source, the page of
+    /// the previous source still being loaded is cancelled.
+    /// onFirstPage is called once the first page is shown, the errors of the next pages are logged.
+    void setSource(Source source, OnFirstPage onFirstPage = nullptr)
+    {
+        cancelFetch();
+        beginResetModel();
+        m_source = source;
+        m_rows.clear();
+        m_isExhausted = !m_source;
+        endResetModel();
+        m_onFirstPage = onFirstPage;
+        fetchMore(QModelIndex());
+    }
+
+    const Row& row(int i) const { return m_rows[i]; }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+
+    void removeRowById(int id)
+    {
+        for (int i = 0; i < m_rows.size(); ++i) {
+            if (m_rowId(m_rows[i]) == id) {
+                beginRemoveRows(QModelIndex(), i, i);
+                m_rows.remove(i);
+                endRemoveRows();
+                return;
+            }
+        }
+    }
+
+    void updateRowById(const Row& row)
+    {
+        for (int i = 0; i < m_rows.size(); ++i) {
+            if (m_rowId(m_rows[i]) == m_rowId(row)) {
+                m_rows[i] = row;
+                emit dataChanged(index(i, 0), index(i, columnCount() - 1));
+                return;
+            }
+        }
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_rows.size();
+    }
+
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_headers.size();
+    }
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (!index.isValid() || index.row() >= m_rows.size() || role != Qt::DisplayRole) {
+            return QVariant();
+        }
+        return m_cell(m_rows[index.row()], index.column());
+    }
+
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override
+    {
+        if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section >= m_headers.size()) {
+            return QAbstractTableModel::headerData(section, orientation, role);
+        }
+        return m_headers[section];
+    }
+
+    bool canFetchMore(const QModelIndex &parent) const override
+    {
+        return !parent.isValid() && !m_isExhausted && !m_fetching;
+    }
+
+    void fetchMore(const QModelIndex &parent) override
+    {
+        if (!canFetchMore(parent)) {
+            return;
+        }
+        const int afterId = m_rows.isEmpty() ? 0 : m_rowId(m_rows.last());
+        m_fetching = new QFutureWatcher<DatabaseReply<QVector<Row>>>(this);
+        QObject::connect(m_fetching, &QFutureWatcherBase::finished, this, [this]() {
+            QFuture<DatabaseReply<QVector<Row>>> future = m_fetching->future();
+            m_fetching->deleteLater();
+            m_fetching = nullptr;
+            appendPage(future.resultCount() > 0 ? future.result() : DatabaseReply<QVector<Row>>());
+        });
+        m_fetching->setFuture(m_source(afterId, PAGE_SIZE));
+    }
+
+private:
+    void appendPage(const DatabaseReply<QVector<Row>>& reply)
+    {
+        const QVector<Row>& page = reply.result;
+        m_isExhausted = page.size() < PAGE_SIZE;    // a short page is the last one
+        if (!page.isEmpty()) {
+            beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + page.size() - 1);
+            m_rows += page;
+            endInsertRows();
+        }
+        if (m_onFirstPage) {
+            auto onFirstPage = m_onFirstPage;
+            m_onFirstPage = nullptr;
+            onFirstPage(reply.errors);
+        } else if (!reply.errors.isEmpty()) {
+            qDebug() << reply.errors;
+        }
+    }
+
+    void cancelFetch()
+    {
+        if (!m_fetching) {
+            return;
+        }
+        m_fetching->disconnect(this);
+        m_fetching->cancel();
+        m_fetching->deleteLater();
+        m_fetching = nullptr;
+    }
+
+    QStringList     m_headers;
+    Cell            m_cell;
+    RowId           m_rowId;
+    Source          m_source;
+    QVector<Row>    m_rows;
+    bool            m_isExhausted = true;
+    QFutureWatcher<DatabaseReply<QVector<Row>>>*   m_fetching = nullptr;      // the page being loaded
+    OnFirstPage                     m_onFirstPage;
+};
+
+#endif // PAGEDTABLEMODEL_H
@@ -26,6 +26,7 @@ void ProductEdit::setInformation(const ProductEntity &p)
     _isEditingMod = true;
 
     _product.setId(p.id());
+    _product.setVersion(p.version());
 
     ui->lineEdit_productName->setText(p.name());
     ui->lineEdit_numProtein->setText(QLocale::system().toString(p.proteins()));
@@ -70,6 +71,7 @@ void ProductEdit::onPushButtonSave()
     float kcal = QLocale::system().toDouble(ui->lineEdit_numKcal->text());
     QString description = ui->textEdit_description->toPlainText();
 
+    const int version = _product.version();
     _product = ProductEntity(_product.id()
                              , productName
                              , description
@@ -78,6 +80,7 @@ void ProductEdit::onPushButtonSave()
                              , carbohydrates
                              , kcal
                              , ui->comboBox->currentIndex() == 0 ? ProductEntity::GRAMM : ui->comboBox->currentIndex() == 1 ? ProductEntity::MILLILITER : ProductEntity::UNDEF); //WARNIND: TODO:
+    _product.setVersion(version);
 
     if (_isEditingMod) {
         emit formEditedProductReady();
@@ -1,5 +1,6 @@
 #include "ProductSeach.h"
 #include "ui_Product_seach.h"
+#include <QHeaderView>
 #include <QDebug>
 
 ProductSeach::ProductSeach(QWidget *parent) :
@@ -8,13 +9,33 @@ ProductSeach::ProductSeach(QWidget *parent) :
 {
     ui->setupUi(this);
 
+    m_model = new PagedTableModel<ProductEntity>(
+                { tr("Название"), tr("Б"), tr("Ж"), tr("У"), tr("Ккал") },
+                [](const ProductEntity& product, int column) -> QVariant {
+                    switch (column) {
+                    case 0: return product.name();
+                    case 1: return QLocale::system().toString(product.proteins());
+                    case 2: return QLocale::system().toString(product.fats());
+                    case 3: return QLocale::system().toString(product.carbohydrates());
+                    case 4: return QLocale::system().toString(product.kilocalories());
+                    }
+                    return QVariant();
+                },
+                [](const ProductEntity& product) { return product.id(); },
+                this);
+    ui->tableView_products->setModel(m_model);
+
+    m_typingTimer.setSingleShot(true);
+    m_typingTimer.setInterval(TYPING_DELAY_MS);
+    connect(ui->lineEdit_productName, SIGNAL(textEdited(QString)), &m_typingTimer, SLOT(start()));
+    connect(&m_typingTimer, SIGNAL(timeout()), SLOT(onProductNameTyped()));
     connect(ui->pushButton_search, SIGNAL(pressed()), SLOT(onPushButtonSeach()));
     connect(ui->pushButton_searchAll, SIGNAL(pressed()), SIGNAL(requireUpdateAllInform()));
     connect(ui->radioButton_productSearch, SIGNAL(pressed()), SLOT(onProductNameSeachType()));
     connect(ui->radioButton_proteinSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
     connect(ui->radioButton_fatsSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
     connect(ui->radioButton_carbohydratesSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
-    connect(ui->tableWidget_products, SIGNAL(pressed(QModelIndex)), SLOT(onSelectProduct(QModelIndex)));
+    connect(ui->tableView_products, SIGNAL(pressed(QModelIndex)), SLOT(onSelectProduct(QModelIndex)));
 }
 
 ProductSeach::~ProductSeach()
@@ -24,13 +45,13 @@ ProductSeach::~ProductSeach()
 
 void ProductSeach::paintEvent(QPaintEvent *event)
 {
-    auto width = ui->tableWidget_products->width();
-    ui->tableWidget_products->horizontalHeader()->setStretchLastSection(true);
-    ui->tableWidget_products->setColumnWidth(0, width * 5/9-10);
-    ui->tableWidget_products->setColumnWidth(1, width * 1/9-10);
-    ui->tableWidget_products->setColumnWidth(2, width * 1/9-10);
-    ui->tableWidget_products->setColumnWidth(3, width * 1/9-10);
-    ui->tableWidget_products->setColumnWidth(4, width * 1/9-10);
+    auto width = ui->tableView_products->width();
+    ui->tableView_products->horizontalHeader()->setStretchLastSection(true);
+    ui->tableView_products->setColumnWidth(0, width * 5/9-10);
+    ui->tableView_products->setColumnWidth(1, width * 1/9-10);
+    ui->tableView_products->setColumnWidth(2, width * 1/9-10);
+    ui->tableView_products->setColumnWidth(3, width * 1/9-10);
+    ui->tableView_products->setColumnWidth(4, width * 1/9-10);
 
     QWidget::paintEvent(event);
 }
@@ -42,64 +63,37 @@ ProductEntity ProductSeach::selectedProduct() const
 
 void ProductSeach::setInformation(const QVector<ProductEntity> &products)
 {
-    _products = products;
-
-    ui->tableWidget_products->setRowCount(_products.size());
-
-    for(int iRow = 0; iRow < _products.size(); ++iRow) {
-        QStringList strColumns;
-        strColumns << _products[iRow].name()
-                   << QLocale::system().toString(_products[iRow].proteins())
-                   << QLocale::system().toString(_products[iRow].fats())
-                   << QLocale::system().toString(_products[iRow].carbohydrates())
-                   << QLocale::system().toString(_products[iRow].kilocalories());
-        for(int iCol = 0; iCol < strColumns.size(); ++iCol) {
-            ui->tableWidget_products->setItem(iRow, iCol, new QTableWidgetItem(strColumns[iCol]));
-        }
-    }
+    m_model->setRows(products);
+}
+
+void ProductSeach::setInformationSource(PagedTableModel<ProductEntity>::Source source, PagedTableModel<ProductEntity>::OnFirstPage onFirstPage)
+{
+    m_model->setSource(source, onFirstPage);
+}
 
-    this->repaint();
+bool ProductSeach::isEmpty() const
+{
+    return m_model->isEmpty();
 }
 
 void ProductSeach::hideInformationIfExists(const ProductEntity &product)
 {
-    for(const auto &tmp : _products){
-        if (tmp.id() == product.id()){
-            for(int i = 0; ui->tableWidget_products->rowCount(); ++i){
-                if (tmp.name() == ui->tableWidget_products->item(i, 0)->text()){
-                    ui->tableWidget_products->removeRow(i);
-                    return;
-                }
-            }
-        }
-    }
+    m_model->removeRowById(product.id());
 }
 
 void ProductSeach::updateInformationIfExist(ProductEntity &product)
 {
-    for(const auto &tmp : _products){
-        if (tmp.id() == product.id()){
-            for(int i = 0; ui->tableWidget_products->rowCount(); ++i){
-                if (tmp.name() == ui->tableWidget_products->item(i, 0)->text()){
-                    ui->tableWidget_products->item(i, 0)->setText(product.name());
-                    ui->tableWidget_products->item(i, 1)->setText(QLocale::system().toString(product.proteins()));
-                    ui->tableWidget_products->item(i, 2)->setText(QLocale::system().toString(product.fats()));
-                    ui->tableWidget_products->item(i, 3)->setText(QLocale::system().toString(product.carbohydrates()));
-                    ui->tableWidget_products->item(i, 4)->setText(QLocale::system().toString(product.kilocalories()));
-                    return;
-                }
-            }
-        }
-    }
+    m_model->updateRowById(product);
 }
 
 int ProductSeach::getCurrentRow()
 {
-    return ui->tableWidget_products->currentRow();
+    return ui->tableView_products->currentIndex().row();
 }
 
 void ProductSeach::onPushButtonSeach()
 {
+    m_typingTimer.stop();
     int from = 0;
     int to = 0;
     if (ui->radioButton_productSearch->isChecked()) {
@@ -122,6 +116,13 @@ void ProductSeach::onPushButtonSeach()
     }
 }
 
+void ProductSeach::onProductNameTyped()
+{
+    if (ui->radioButton_productSearch->isChecked()) {
+        emit seachLineProductTyped(ui->lineEdit_productName->text());
+    }
+}
+
 void ProductSeach::onProductNameSeachType()
 {
     ui->stackedWidget->setCurrentIndex(1);
@@ -134,13 +135,13 @@ void ProductSeach::onPFCSeachType()
 
 void ProductSeach::onSelectProduct(const QModelIndex &index)
 {
-    int selectedProduct = index.row();
-    if (selectedProduct >= _products.size() && selectedProduct < 0)
+    if (!index.isValid() || index.row() >= m_model->rowCount())
     {
         qDebug() << "Error: ProductSeach::onSelectProduct(const QModelIndex &)"
                  << "Not correct client vector index";
+        return;
     }
-    _selectedProduct = _products[selectedProduct];
+    _selectedProduct = m_model->row(index.row());
     emit selectedForShow();
 }
 
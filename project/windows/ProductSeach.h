@@ -2,8 +2,10 @@
 #define PRODUCTSEACH_H
 
 #include <QWidget>
+#include <QTimer>
 #include <QVector>
 #include "entities/product.h"
+#include "PagedTableModel.h"
 
 namespace Ui {
 class ProductSeach;
@@ -20,6 +22,8 @@ public:
     void paintEvent(QPaintEvent *event) override;
 
     void setInformation(const QVector<ProductEntity>& );
+    void setInformationSource(PagedTableModel<ProductEntity>::Source source, PagedTableModel<ProductEntity>::OnFirstPage onFirstPage = nullptr);  // loaded page by page while scrolling
+    bool isEmpty() const;
     void hideInformationIfExists(const ProductEntity &product);
     void updateInformationIfExist(ProductEntity & );
 
@@ -28,6 +32,7 @@ public:
 
 signals:
     void seachLineProductReady(const QString& );
+    void seachLineProductTyped(const QString& );         // while typing, after a pause
     void seachLineProteinReady(const int from, const int to);
     void seachLineFatsReady(const int from, const int to);
     void seachLineCarbohydratesReady(const int from, const int to);
@@ -36,13 +41,17 @@ signals:
 
 private slots:
     void onPushButtonSeach();
+    void onProductNameTyped();
     void onProductNameSeachType();
     void onPFCSeachType();
     void onSelectProduct(const QModelIndex& );
 
 private:
+    static constexpr int TYPING_DELAY_MS = 250;
+
     Ui::ProductSeach *ui;
-    QVector<ProductEntity> _products;
+    PagedTableModel<ProductEntity> *m_model;
+    QTimer m_typingTimer;                  // restarted by every key, the search runs once it fires
     ProductEntity _selectedProduct;
 };
 
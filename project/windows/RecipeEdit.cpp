@@ -118,7 +118,9 @@ void RecipeEdit::onPushButtonSave()
         item = *ui->tableWidget_recipeDescription->takeItem(i, 0);
         cookingPoints.push_back(item.text());
     }
+    const int version = _recipe.version();
     _recipe = RecipeEntity(_recipe.id(), recipeName, produsctsList, cookingPoints);
+    _recipe.setVersion(version);
 
 
     if (_isEditingMod) {
@@ -1,12 +1,7 @@
 #include "RecipeInfo.h"
 #include "ui_Recipe_info.h"
 
-#include <QPrinter>
-#include <QPaintDevice>
-#include <QPrintPreviewDialog>
-#include <QTextCursor>
-#include <QTextDocument>
-#include <QTextTable>
+#include "printer.h"
 
 RecipeInfo::RecipeInfo(QWidget *parent) :
     QWidget(parent),
@@ -29,7 +24,7 @@ RecipeInfo::RecipeInfo(QWidget *parent) :
 void RecipeInfo::setInformation(const RecipeEntity &r)
 {
     _recipe = r;
-    QVector<WeightedProduct> products = _recipe.getPoducts();
+    const QVector<WeightedProduct>& products = _recipe.products();
     ui->label_recipeName->setText(_recipe.name());
     ui->tableWidget_ingredientList->setRowCount(products.size());
 
@@ -39,16 +34,13 @@ void RecipeInfo::setInformation(const RecipeEntity &r)
         ui->tableWidget_ingredientList->setItem(iRow, 2, new QTableWidgetItem(products.at(iRow).product().units() == ProductEntity::GRAMM ? "гр" : products.at(iRow).product().units() == ProductEntity::MILLILITER ? "мл" : "???"));
     }
 
-    auto proteins = QLocale::system().toString(_recipe.proteins());
-    ui->label_numProtein->setText(proteins);
-    auto fats = QLocale::system().toString(_recipe.fats());
-    ui->label_numFats->setText(fats);
-    auto carbohydrates = QLocale::system().toString(_recipe.carbohydrates());
-    ui->label_numCarbohydrates->setText(carbohydrates);
-    auto kcal = QLocale::system().toString(_recipe.kkal());
-    ui->label_numKcal->setText(kcal);
+    const NutritionFacts& nutrition = _recipe.nutrition();
+    ui->label_numProtein->setText(QLocale::system().toString(nutrition.proteins));
+    ui->label_numFats->setText(QLocale::system().toString(nutrition.fats));
+    ui->label_numCarbohydrates->setText(QLocale::system().toString(nutrition.carbohydrates));
+    ui->label_numKcal->setText(QLocale::system().toString(nutrition.kilocalories));
 
-    QStringList cookingPoints = _recipe.getCookingPoints();
+    const QStringList& cookingPoints = _recipe.cookingPoints();
     ui->tableWidget_recipeDescription->setRowCount(cookingPoints.size());
 
     for (int iRow = 0; iRow < cookingPoints.size(); ++iRow) {
@@ -80,132 +72,8 @@ void RecipeInfo::paintEvent(QPaintEvent *event)
 
 void RecipeInfo::onPrintButtonPressed()
 {
-    QString resipeName = "Рецепт: " + ui->label_recipeName->text();
-
-    QPrinter* _printer;
-
-
-    _printer = new QPrinter(QPrinter::HighResolution);
-    _printer->setOrientation(QPrinter::Portrait);
-    _printer->setPageMargins(QMarginsF(10, 10, 10, 10), QPageLayout::Millimeter);
-    _printer->setPaperSize(QPrinter::A4);
-    _printer->setDocName(resipeName);
-
-    QPrintPreviewDialog* dialog = new QPrintPreviewDialog(_printer, this);
-    dialog->setWindowFlags(Qt::Window);
-    dialog->setAttribute(Qt::WA_DeleteOnClose);
-    dialog->setWindowTitle(resipeName);
-    connect(dialog, SIGNAL(paintRequested(QPrinter*)), SLOT(printRequest(QPrinter*)));
-    dialog->exec();
-}
-
-void RecipeInfo::printRequest(QPrinter *printer)
-{
-    QTextCursor cursor;
-    QTextDocument document;
-    document.setDefaultFont(QFont("Times New Roman"));
-    cursor = QTextCursor(&document);
-
-    auto drawTitle = [&cursor](QString s){
-        QTextCharFormat boldWeight;
-        boldWeight.setFontWeight(QFont::Bold);
-        QTextBlockFormat centerAlignment;
-        centerAlignment.setAlignment(Qt::AlignCenter);
-
-        cursor.setBlockFormat(centerAlignment);
-        cursor.insertText(s, boldWeight);
-        cursor.insertBlock();
-        cursor.insertBlock();
-    };
-
-    auto drawTableHeader = [&cursor](QImage img, float kcal, float proteins, float fats, float carb){
-       // QTextTableFormat tableFormat;
-        QTextTable *table = cursor.insertTable(1, 2);
-
-
-        QTextTableCell cell = table->cellAt(0,0);
-        QTextCursor cellCursor = cell.firstCursorPosition();
-        cellCursor.insertImage(img.scaled(280,280));
-
-        cell = table->cellAt(0,1);
-        cellCursor = cell.firstCursorPosition();
-        cellCursor.insertText("ЭНЕРГЕТИЧЕСКАЯ ЦЕННОСТЬ");
-        cellCursor.insertBlock();
-        cellCursor.insertBlock();
-        QTextTable *subTable = cellCursor.insertTable(4,1);
-
-        QTextTableCell subCell = subTable->cellAt(0,0);
-        QTextCursor subCellCursor = subCell.firstCursorPosition();
-        subCellCursor.insertText("КАЛОРИЙНОСТЬ");
-        subCellCursor.insertBlock();
-        subCellCursor.insertText(QString::number(kcal));
-        subCellCursor.insertBlock();
-        subCellCursor.insertText("ккал");
-        subCellCursor.movePosition(QTextCursor::NextCell);
-        subCellCursor.insertText("БЕЛКИ");
-        subCellCursor.insertBlock();
-        subCellCursor.insertText(QString::number(kcal));
-        subCellCursor.insertBlock();
-        subCellCursor.insertText("грамм");
-        subCellCursor.movePosition(QTextCursor::NextCell);
-        subCellCursor.insertText("ЖИРЫ");
-        subCellCursor.insertBlock();
-        subCellCursor.insertText(QString::number(fats));
-        subCellCursor.insertBlock();
-        subCellCursor.insertText("грамм");
-        subCellCursor.movePosition(QTextCursor::NextCell);
-        subCellCursor.insertText("УГЛЕВОДЫ");
-        subCellCursor.insertBlock();
-        subCellCursor.insertText(QString::number(carb));
-        subCellCursor.insertBlock();
-        subCellCursor.insertText("грамм");
-
-        //cellCursor.insertText("* КАЛОРИЙНОСТЬ РАССЧИТАНА ДЛЯ СЫРЫХ ПРОДУКТОВ");
-        cursor.movePosition(QTextCursor::End);
-    };
-
-    auto drawTableIngredients = [&cursor](const RecipeEntity &recipe){
-        cursor.insertBlock();
-        cursor.insertBlock();
-        cursor.insertText("ИНГРЕДИЕНТЫ");
-        cursor.insertBlock();
-
-        int rows = recipe.products().size();
-        QTextTable *table = cursor.insertTable(rows, 3);
-        for (auto product : recipe.products()){
-            cursor.insertText(product.product().name());
-            cursor.movePosition(QTextCursor::NextCell);
-            cursor.insertText(QString::number(product.amound()));
-            cursor.movePosition(QTextCursor::NextCell);
-            cursor.insertText(product.product().units() == ProductEntity::GRAMM ? "гр" : product.product().units() == ProductEntity::MILLILITER ? "мл" : "???");
-            cursor.movePosition(QTextCursor::NextCell);
-        }
-        cursor.movePosition(QTextCursor::End);
-    };
-
-    auto drawTableCookingpoint = [&cursor](const RecipeEntity &recipe){
-        cursor.insertBlock();
-        cursor.insertBlock();
-        cursor.insertText("ИНСТРУКЦИЯ ПРИГОТОВЛЕНИЯ");
-        cursor.insertBlock();
-
-        int rows = recipe.cookingPoints().size();
-        QTextTable *table = cursor.insertTable(rows, 2);
-        for (int i = 0; i < rows; ++ i){
-            cursor.insertText(QString::number(i+1));
-            cursor.movePosition(QTextCursor::NextCell);
-            cursor.insertText(recipe.cookingPoints().at(i));
-            cursor.movePosition(QTextCursor::NextCell);
-        }
-        cursor.movePosition(QTextCursor::End);
-    };
-
-    drawTitle(ui->label_recipeName->text());
-    drawTableHeader(ui->widget_image->image(), _recipe.kkal(), _recipe.proteins(), _recipe.fats(), _recipe.carbohydrates());
-    drawTableIngredients(_recipe);
-    drawTableCookingpoint(_recipe);
-
-    document.print(printer);
+    Printer* printer = new Printer(this);
+    printer->previewRecipe(_recipe, ui->widget_image->image());
 }
 
 RecipeInfo::~RecipeInfo()
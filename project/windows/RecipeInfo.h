@@ -5,8 +5,6 @@
 #include "entities/recipe.h"
 #include "entities/product.h"
 
-class QPrinter;
-
 namespace Ui {
 class RecipeInfo;
 }
@@ -30,7 +28,6 @@ signals:
 
 private slots:
     void onPrintButtonPressed();
-    void printRequest(QPrinter* printer);
 
 private:
     Ui::RecipeInfo *ui;
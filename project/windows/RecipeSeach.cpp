@@ -1,5 +1,6 @@
 #include "RecipeSeach.h"
 #include "ui_Recipe_seach.h"
+#include <QHeaderView>
 #include <QDebug>
 #include <QVector>
 #include <QString>
@@ -9,98 +10,113 @@ RecipeSeach::RecipeSeach(QWidget *parent) :
     ui(new Ui::RecipeSeach)
 {
     ui->setupUi(this);
+
+    m_model = new PagedTableModel<RecipeSummary>(
+                { tr("Название"), tr("Б"), tr("Ж"), tr("У"), tr("Ккал") },
+                [](const RecipeSummary& recipe, int column) -> QVariant {
+                    switch (column) {
+                    case 0: return recipe.name;
+                    case 1: return QLocale::system().toString(recipe.proteins);
+                    case 2: return QLocale::system().toString(recipe.fats);
+                    case 3: return QLocale::system().toString(recipe.carbohydrates);
+                    case 4: return QLocale::system().toString(recipe.kcal);
+                    }
+                    return QVariant();
+                },
+                [](const RecipeSummary& recipe) { return recipe.id; },
+                this);
+    ui->tableView_recipe->setModel(m_model);
     ui->lineEdit_recipeName->setValidator(new QRegExpValidator(QRegExp("[A-Z/a-z/а-я/A-Я\\s]{1,}\[A-Z/a-z/а-я/A-Я\\s]{1,}")));
 
+    m_typingTimer.setSingleShot(true);
+    m_typingTimer.setInterval(TYPING_DELAY_MS);
+    connect(ui->lineEdit_recipeName, SIGNAL(textEdited(QString)), &m_typingTimer, SLOT(start()));
+    connect(&m_typingTimer, SIGNAL(timeout()), SLOT(onRecipeNameTyped()));
     connect(ui->pushButton_search, SIGNAL(pressed()), SLOT(onPushButtonSeach()));
     connect(ui->pushButton_searchAll, SIGNAL(pressed()), SIGNAL(requireUpdateAllInform()));
     connect(ui->radioButton_productSearch, SIGNAL(pressed()), SLOT(onRecipeNameSeachType()));
     connect(ui->radioButton_proteinSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
     connect(ui->radioButton_fatsSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
     connect(ui->radioButton_carbohydratesSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
-    connect(ui->tableWidget_recipe, SIGNAL(pressed(QModelIndex)), SLOT(onSelectRecipe(QModelIndex)));
+    connect(ui->radioButton_kcalSearch, SIGNAL(pressed()), SLOT(onPFCSeachType()));
+    connect(ui->tableView_recipe, SIGNAL(pressed(QModelIndex)), SLOT(onSelectRecipe(QModelIndex)));
 }
 
-void RecipeSeach::setInformation(const QVector<RecipeEntity> &recipes)
+void RecipeSeach::setInformation(const QVector<RecipeSummary> &recipes)
 {
-    _recipes = recipes;
-
-    ui->tableWidget_recipe->setRowCount(_recipes.size());
-
-    for (int iRow = 0; iRow < _recipes.size(); ++iRow) {
-        QVector<QString> itemValues = {
-            _recipes[iRow].name(),
-            QLocale::system().toString(_recipes[iRow].proteins()),
-            QLocale::system().toString(_recipes[iRow].fats()),
-            QLocale::system().toString(_recipes[iRow].carbohydrates()),
-            QLocale::system().toString(_recipes[iRow].kkal())
-        };
-        for(int i = 0; i < itemValues.size(); ++i){
-            QTableWidgetItem* item = new QTableWidgetItem(itemValues[i]);
-            ui->tableWidget_recipe->setItem(iRow, i, item);
-        }
-    }
-    this->repaint();
+    m_model->setRows(recipes);
+}
+
+void RecipeSeach::setInformationSource(PagedTableModel<RecipeSummary>::Source source, PagedTableModel<RecipeSummary>::OnFirstPage onFirstPage)
+{
+    m_model->setSource(source, onFirstPage);
 }
 
-RecipeEntity RecipeSeach::selectedRecipe() const
+bool RecipeSeach::isEmpty() const
+{
+    return m_model->isEmpty();
+}
+
+RecipeSummary RecipeSeach::selectedRecipe() const
 {
     return _selectedRecipe;
 }
 
 void RecipeSeach::hideInformationIfExists(const RecipeEntity &recipe)
 {
-    for(const auto &tmp : _recipes){
-        if (tmp.id() == recipe.id()){
-            for(int i = 0; ui->tableWidget_recipe->rowCount(); ++i){
-                if (tmp.name() == ui->tableWidget_recipe->item(i, 0)->text()){
-                    ui->tableWidget_recipe->removeRow(i);
-                    return;
-                }
-            }
-        }
-    }
+    m_model->removeRowById(recipe.id());
 }
 
 void RecipeSeach::updateInformationIfExist(RecipeEntity &recipe)
 {
-    for(const auto &tmp : _recipes){
-        if (tmp.id() == recipe.id()){
-            for(int i = 0; ui->tableWidget_recipe->rowCount(); ++i){
-                if (tmp.name() == ui->tableWidget_recipe->item(i, 0)->text()){
-                    ui->tableWidget_recipe->item(i, 0)->setText(recipe.name());
-                    ui->tableWidget_recipe->item(i, 0)->setText(QLocale::system().toString(recipe.proteins()));
-                    ui->tableWidget_recipe->item(i, 0)->setText(QLocale::system().toString(recipe.fats()));
-                    ui->tableWidget_recipe->item(i, 0)->setText(QLocale::system().toString(recipe.carbohydrates()));
-                    ui->tableWidget_recipe->item(i, 0)->setText(QLocale::system().toString(recipe.kkal()));
-                    return;
-                }
-            }
-        }
-    }
+    RecipeSummary summary;
+    summary.id = recipe.id();
+    summary.name = recipe.name();
+    const NutritionFacts& nutrition = recipe.nutrition();
+    summary.proteins = nutrition.proteins;
+    summary.fats = nutrition.fats;
+    summary.carbohydrates = nutrition.carbohydrates;
+    summary.kcal = nutrition.kilocalories;
+    summary.weight = nutrition.weight;
+    m_model->updateRowById(summary);
 }
+
 void RecipeSeach::onPushButtonSeach()
 {
-    int from = 0;
-    int to = 0;
+    m_typingTimer.stop();
     if (ui->radioButton_productSearch->isChecked()) {
         QString seach = ui->lineEdit_recipeName->text();
         if (!seach.isEmpty()) {
             emit seachLineRecipeReady(seach);
         }
-    } else if (ui->radioButton_proteinSearch->isChecked()) {
-        from = ui->spinBox_From->value();
-        to = ui->spinBox_To->value();
-        emit seachLineProteinReady(from, to);
+        return;
+    }
+
+    /// A new search starts from no ranges, a refined one adds the range to the previous ones
+    RecipeCatalog::Basis basis = ui->checkBox_per100Grams->isChecked() ? RecipeCatalog::Per100Grams
+                                                                       : RecipeCatalog::PerPortion;
+    if (!ui->checkBox_refine->isChecked() || m_filter.basis != basis) {
+        m_filter = RecipeCatalog::Filter();
+        m_filter.basis = basis;
+    }
+    RecipeCatalog::Range range{ float(ui->spinBox_From->value()), float(ui->spinBox_To->value()) };
+    if (ui->radioButton_proteinSearch->isChecked()) {
+        m_filter.proteins = range;
     } else if (ui->radioButton_fatsSearch->isChecked()) {
-        from = ui->spinBox_From->value();
-        to = ui->spinBox_To->value();
-        emit seachLineFatsReady(from, to);
+        m_filter.fats = range;
     } else if (ui->radioButton_carbohydratesSearch->isChecked()) {
-        from = ui->spinBox_From->value();
-        to = ui->spinBox_To->value();
-        emit seachLineCarbohydratesReady(from, to);
+        m_filter.carbohydrates = range;
+    } else if (ui->radioButton_kcalSearch->isChecked()) {
+        m_filter.kilocalories = range;
     }
+    emit seachNutrientsReady(m_filter);
+}
 
+void RecipeSeach::onRecipeNameTyped()
+{
+    if (ui->radioButton_productSearch->isChecked()) {
+        emit seachLineRecipeTyped(ui->lineEdit_recipeName->text());
+    }
 }
 
 void RecipeSeach::onRecipeNameSeachType()
@@ -115,13 +131,13 @@ void RecipeSeach::onPFCSeachType()
 
 void RecipeSeach::onSelectRecipe(const QModelIndex &index)
 {
-    int selectedRecipe = index.row();
-    if (selectedRecipe >= _recipes.size() && selectedRecipe < 0)
+    if (!index.isValid() || index.row() >= m_model->rowCount())
     {
-        qDebug() << "Error: ProductSeach::onSelectProduct(const QModelIndex &)"
+        qDebug() << "Error: RecipeSeach::onSelectRecipe(const QModelIndex &)"
                  << "Not correct client vector index";
+        return;
     }
-    _selectedRecipe = _recipes[selectedRecipe];
+    _selectedRecipe = m_model->row(index.row());
     emit selectedForShow();
 }
 
@@ -133,13 +149,13 @@ RecipeSeach::~RecipeSeach()
 
 void RecipeSeach::paintEvent(QPaintEvent *event)
 {
-    auto width = ui->tableWidget_recipe->width();
-    ui->tableWidget_recipe->horizontalHeader()->setStretchLastSection(true);
-    ui->tableWidget_recipe->setColumnWidth(0, width * 8/12-10);
-    ui->tableWidget_recipe->setColumnWidth(1, width * 1/12-10);
-    ui->tableWidget_recipe->setColumnWidth(2, width * 1/12-10);
-    ui->tableWidget_recipe->setColumnWidth(3, width * 1/12-10);
-    ui->tableWidget_recipe->setColumnWidth(4, width * 1/12-10);
+    auto width = ui->tableView_recipe->width();
+    ui->tableView_recipe->horizontalHeader()->setStretchLastSection(true);
+    ui->tableView_recipe->setColumnWidth(0, width * 8/12-10);
+    ui->tableView_recipe->setColumnWidth(1, width * 1/12-10);
+    ui->tableView_recipe->setColumnWidth(2, width * 1/12-10);
+    ui->tableView_recipe->setColumnWidth(3, width * 1/12-10);
+    ui->tableView_recipe->setColumnWidth(4, width * 1/12-10);
 
     QWidget::paintEvent(event);
 }
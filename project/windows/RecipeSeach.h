@@ -2,7 +2,11 @@
 #define RECIPESEACH_H
 
 #include <QWidget>
+#include <QTimer>
 #include "entities/recipe.h"
+#include "entities/summaries.h"
+#include "PagedTableModel.h"
+#include "recipecatalog.h"
 
 namespace Ui {
 class RecipeSeach;
@@ -18,29 +22,35 @@ public:
 
     void paintEvent(QPaintEvent *event) override;
 
-    void setInformation(const QVector<RecipeEntity>&);
-    RecipeEntity selectedRecipe() const;
+    void setInformation(const QVector<RecipeSummary>&);
+    void setInformationSource(PagedTableModel<RecipeSummary>::Source source, PagedTableModel<RecipeSummary>::OnFirstPage onFirstPage = nullptr);  // loaded page by page while scrolling
+    bool isEmpty() const;
+    RecipeSummary selectedRecipe() const;
     void hideInformationIfExists(const RecipeEntity &recipe);
     void updateInformationIfExist(RecipeEntity & );
 
 signals:
     void seachLineRecipeReady(const QString& );
-    void seachLineProteinReady(const int from, const int to);
-    void seachLineFatsReady(const int from, const int to);
-    void seachLineCarbohydratesReady(const int from, const int to);
+    void seachLineRecipeTyped(const QString& );         // while typing, after a pause
+    void seachNutrientsReady(const RecipeCatalog::Filter& );      // the ranges refined since the last new search
     void selectedForShow();
     void requireUpdateAllInform();
 
 private slots:
     void onPushButtonSeach();
+    void onRecipeNameTyped();
     void onRecipeNameSeachType();
     void onPFCSeachType();
     void onSelectRecipe(const QModelIndex& );
 
 private:
+    static constexpr int TYPING_DELAY_MS = 250;
+
     Ui::RecipeSeach *ui;
-    QVector<RecipeEntity> _recipes;
-    RecipeEntity _selectedRecipe;
+    PagedTableModel<RecipeSummary> *m_model;
+    QTimer m_typingTimer;                  // restarted by every key, the search runs once it fires
+    RecipeSummary _selectedRecipe;
+    RecipeCatalog::Filter m_filter;
 
 };
 